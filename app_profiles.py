@@ -0,0 +1,63 @@
+# *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+#************* Mon site web : henribikouri.github.io *************************
+#*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+# Lecture des fichiers de profils d'application de simulation-domestique (--profilesFile),
+# pour que demoPerformance.py, pcap_to_dataset.py et train_classifier.py nomment et étiquettent
+# les ports comme la simulation. Format : voir scratch/simulation-domestique-profiles.h.
+# Les profils intégrés sont lus dans default_profiles.txt (écrit par --exportProfiles), pas recopiés dans les scripts.
+
+import os
+import sys
+
+DEFAULT_PROFILES_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'default_profiles.txt')
+
+
+def load_profile_flows(path):
+    """
+    Retourne la liste des flux du fichier, un dictionnaire par ligne 'flow'
+    (clés 'profile', 'port', 'name', 'label' et les autres clés de la ligne, en texte).
+    """
+    flows = []
+    profile = None
+    with open(path, encoding="utf-8") as f:
+        for line_number, line in enumerate(f, 1):
+            fields = line.split('#', 1)[0].split()
+            if not fields:
+                continue
+            values = dict(field.split('=', 1) for field in fields[1:] if '=' in field)
+            if fields[0] == 'profile':
+                profile = values.get('key')
+            elif fields[0] == 'flow' and profile is not None and 'port' in values and 'name' in values:
+                values['profile'] = profile
+                values['port'] = int(values['port'])
+                values['label'] = int(values.get('label', 0))
+                flows.append(values)
+            else:
+                raise ValueError(f"{path}:{line_number} : ligne de profil invalide")
+    return flows
+
+
+def profiles_file_from_argv(argv=None):
+    """
+    Retire '--profiles=<fichier>' des arguments et retourne (fichier ou None, arguments restants).
+    """
+    argv = list(sys.argv[1:] if argv is None else argv)
+    path = None
+    for arg in list(argv):
+        if arg.startswith('--profiles='):
+            path = arg.split('=', 1)[1]
+            argv.remove(arg)
+    return path, argv
+
+
+def load_profiles(argv=None):
+    """
+    Retourne (flux des profils intégrés suivis de ceux de '--profiles=<fichier>', arguments restants).
+    """
+    path, argv = profiles_file_from_argv(argv)
+    flows = load_profile_flows(DEFAULT_PROFILES_FILE)
+    if path:
+        flows += load_profile_flows(path)
+    return flows, argv
@@ -6,26 +6,16 @@
 import pandas as pd
 import matplotlib.pyplot as plt
 import os
+import sys
+from app_profiles import load_profiles
 
 # Configuration
 CSV_FILE_PATH = 'metrics_test.csv' 
 OUTPUT_PLOT_PATH_THROUGHPUT = 'demo_results_throughput.png' # image de sortie pour debits
 OUTPUT_PLOT_PATH_QOS = 'demo_results_qos.png' # images de sortie pour la QoS
 
-# Mapping complet des ports aux applications
-PORT_TO_APP_NAME = {
-    9001: 'Caméra',
-    9002: 'Capteur (Sporadique)',
-    9003: 'Assistant Vocal (Rafale)',
-    9004: 'Téléchargement (Débit Max)',
-    9005: 'VoIP Montante',
-    9006: 'VoIP Descendante',
-    9007: 'Domotique (Aléatoire)',
-    9008: 'Diffusion (Streaming)',
-    9009: 'Sonnette (Très Sporadique)',
-    9010: 'Mise à Jour Firmware (Inactif)',
-    9011: 'Supervision',
-}
+# Nom des applications par port, rempli par les profils (app_profiles.load_profiles)
+PORT_TO_APP_NAME = {}
 
 
 def analyze_and_plot_results(csv_path):
@@ -43,6 +33,8 @@ def analyze_and_plot_results(csv_path):
     THROUGHPUT_COLUMN = 'throughputMbps'
     DELAY_COLUMN = 'meanDelayMs'
     LOSS_COLUMN = 'lossPct'
+    # Port de l'application : 'dstPort' pour le CSV par flux, 'port' pour un résumé ou la table du balayage (sweep-results.csv)
+    PORT_COLUMN = 'dstPort' if 'dstPort' in df.columns else 'port'
     
     # Filtrer les débits > 0 pour ne pas inclure les flux complètement inactifs dans les moyennes
     active_df = df[df[THROUGHPUT_COLUMN] > 0]
@@ -52,9 +44,9 @@ def analyze_and_plot_results(csv_path):
         return
 
     # Calculs des moyennes par port de destination (dstPort)
-    throughput_by_app = active_df.groupby('dstPort')[THROUGHPUT_COLUMN].mean()
-    delay_by_app = active_df.groupby('dstPort')[DELAY_COLUMN].mean()
-    loss_by_app = active_df.groupby('dstPort')[LOSS_COLUMN].mean()
+    throughput_by_app = active_df.groupby(PORT_COLUMN)[THROUGHPUT_COLUMN].mean()
+    delay_by_app = active_df.groupby(PORT_COLUMN)[DELAY_COLUMN].mean()
+    loss_by_app = active_df.groupby(PORT_COLUMN)[LOSS_COLUMN].mean()
 
     # Remplace les ports par des noms d'applications pour l'affichage
     def get_app_names(series_index):
@@ -112,4 +104,8 @@ def analyze_and_plot_results(csv_path):
 
 
 if __name__ == "__main__":
-    analyze_and_plot_results(CSV_FILE_PATH)
+    # Un autre fichier peut être passé en argument (ex. la table unique d'un balayage : sweep-results.csv),
+    # et --profiles=<fichier> nomme les ports des profils ajoutés par --profilesFile
+    flows, args = load_profiles()
+    PORT_TO_APP_NAME.update({flow['port']: flow['name'] for flow in flows})
+    analyze_and_plot_results(args[0] if args else CSV_FILE_PATH)
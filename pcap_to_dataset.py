@@ -9,6 +9,7 @@ import time
 import glob
 from collections import defaultdict
 from scapy.all import PcapReader, IP, UDP, TCP
+from app_profiles import load_profiles
 
 # --- CONFIGURATION ---
 # On cherche tous les fichiers commençant par trace-ml-ip générés par la simulation
@@ -16,11 +17,8 @@ PCAP_PATTERN = "trace-ml-ip-*.pcap"
 OUTPUT_CSV = "dataset_ml_features.csv"
 CHUNK_SIZE = 5.0 
 
-# Mapping exact des ports aux labels
-PORT_TO_LABEL = {
-    9001: 1, 9002: 2, 9003: 3, 9004: 4, 9005: 5, 
-    9006: 6, 9007: 7, 9008: 8, 9009: 9, 9010: 10
-}
+# Label par port, rempli par les profils (app_profiles.load_profiles)
+PORT_TO_LABEL = {}
 
 DATASET_HEADER = [
     'LABEL', 'CHUNK_ID', 'NB_PAQUETS', 'VOL_BYTES', 
@@ -126,4 +124,7 @@ def process_pcap_files():
         print("❌ Aucun chunk généré. Vérifiez que la simulation a tourné.")
 
 if __name__ == "__main__":
+    # --profiles=<fichier> : LABEL des ports des profils ajoutés à la simulation par --profilesFile
+    flows, _ = load_profiles()
+    PORT_TO_LABEL.update({flow['port']: flow['label'] for flow in flows if flow['label'] > 0})
     process_pcap_files()
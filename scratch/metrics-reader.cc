@@ -0,0 +1,94 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Lecteur des métriques binaires de simulation-domestique (--metricsFormat=binary).
+// Exemple : ./ns3 run "scratch/metrics-reader --input=simulation-domestique-metrics.bin --flows=true"
+#include "ns3/command-line.h"
+#include "ns3/ipv4-address.h"
+#include "simulation-domestique-metrics.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+// Écrit le résumé par sink, mêmes colonnes que summary-*.csv (moyennes recalculées à partir des sommes)
+void WriteSinks(std::ostream &out, const MetricsSinkColumns &s, double duration)
+{
+    out << "nodeId,port,sinkRxBytes,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs\n";
+    for (std::size_t i = 0; i < s.Size(); ++i)
+    {
+        double lossPct = s.txPackets[i] > 0 ? (double)(s.txPackets[i] - s.rxPackets[i]) * 100.0 / (double)s.txPackets[i] : 0.0;
+        double meanDelayMs = s.rxPackets[i] > 0 ? s.delaySumNs[i] / 1e6 / (double)s.rxPackets[i] : 0.0;
+        double meanJitterMs = s.rxPackets[i] > 0 ? s.jitterSumNs[i] / 1e6 / (double)s.rxPackets[i] : 0.0;
+        double throughputMbps = duration > 0 ? (s.rxBytes[i] * 8.0) / (duration * 1000000.0) : 0.0;
+        out << s.nodeId[i] << "," << s.port[i] << "," << s.sinkRxBytes[i] << "," << s.txPackets[i] << "," << s.rxPackets[i] << ","
+            << s.lostPackets[i] << "," << lossPct << "," << s.txBytes[i] << "," << s.rxBytes[i] << "," << throughputMbps << ","
+            << meanDelayMs << "," << meanJitterMs << "\n";
+    }
+}
+
+// Écrit les flux, mêmes colonnes que le CSV par flux de simulation-domestique (--enableCsv)
+void WriteFlows(std::ostream &out, const MetricsFlowColumns &f)
+{
+    out << "flowId,srcAddr,srcPort,dstAddr,dstPort,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs\n";
+    for (std::size_t i = 0; i < f.Size(); ++i)
+    {
+        double lossPct = f.txPackets[i] > 0 ? (double)(f.txPackets[i] - f.rxPackets[i]) * 100.0 / (double)f.txPackets[i] : 0.0;
+        double durationSeconds = (f.timeLastTxNs[i] - f.timeFirstTxNs[i]) / 1e9;
+        double throughputMbps = durationSeconds > 0.0 ? (f.rxBytes[i] * 8.0) / (durationSeconds * 1000000.0) : 0.0;
+        double meanDelayMs = f.rxPackets[i] > 0 ? f.delaySumNs[i] / 1e6 / (double)f.rxPackets[i] : 0.0;
+        double meanJitterMs = f.rxPackets[i] > 0 ? f.jitterSumNs[i] / 1e6 / (double)f.rxPackets[i] : 0.0;
+        out << f.flowId[i] << "," << Ipv4Address(f.srcAddr[i]) << "," << f.srcPort[i] << "," << Ipv4Address(f.dstAddr[i]) << ","
+            << f.dstPort[i] << "," << f.txPackets[i] << "," << f.rxPackets[i] << "," << f.lostPackets[i] << "," << lossPct << ","
+            << f.txBytes[i] << "," << f.rxBytes[i] << "," << throughputMbps << "," << meanDelayMs << "," << meanJitterMs << "\n";
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    std::string input = "simulation-domestique-metrics.bin";
+    std::string output = "";
+    bool flows = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Read the columnar metrics written by simulation-domestique --metricsFormat=binary and print them as CSV.");
+    cmd.AddValue("input", "Binary metrics file", input);
+    cmd.AddValue("output", "CSV output file (default: standard output)", output);
+    cmd.AddValue("flows", "Print the per-flow table instead of the per-sink summary", flows);
+    cmd.Parse(argc, argv);
+
+    double duration = 0.0;
+    MetricsSinkColumns sinks;
+    MetricsFlowColumns flowColumns;
+    auto start = std::chrono::steady_clock::now();
+    if (!ReadBinaryMetrics(input, duration, sinks, flowColumns))
+    {
+        std::cerr << "Fichier de métriques illisible ou d'un autre format : " << input << std::endl;
+        return 1;
+    }
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << input << " : " << sinks.Size() << " sinks, " << flowColumns.Size() << " flux, durée " << duration
+              << " s, chargé en " << std::fixed << std::setprecision(3) << loadMs << " ms" << std::endl;
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    std::ostream &out = output.empty() ? std::cout : file;
+    out << std::setprecision(6);
+    if (flows)
+    {
+        WriteFlows(out, flowColumns);
+    }
+    else
+    {
+        WriteSinks(out, sinks, duration);
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Version native de pcap_to_dataset.py : extrait les caractéristiques ML des traces trace-ml-ip-*.pcap
+// et écrit dataset_ml_features.csv avec le même schéma
+// (LABEL, CHUNK_ID, NB_PAQUETS, VOL_BYTES, PROTO_TCP_RATIO, IAT_MEAN, IAT_STD).
+//
+// Les fichiers sont projetés en mémoire (mmap) et les en-têtes IPv4/TCP/UDP lus directement ;
+// chaque (label, chunk) ne garde qu'un accumulateur (statistiques de Welford sur les inter-arrivées)
+// au lieu de la liste de ses paquets, et les fichiers sont traités en parallèle.
+//
+// Exemple : ./ns3 run "scratch/pcap-to-dataset --pattern=trace-ml-ip-*.pcap --threads=8"
+#include "ns3/command-line.h"
+#include "simulation-domestique-ml.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <glob.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+// Résultat d'un fichier : chunks dans l'ordre de première apparition (ordre des lignes du script Python)
+struct FileResult
+{
+    std::vector<ChunkAccumulator> chunks;
+    uint64_t packets = 0;
+    bool ok = false;
+};
+
+inline uint32_t ReadU32(const uint8_t *p, bool swapped)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return swapped ? __builtin_bswap32(v) : v;
+}
+
+/**
+ * @brief Traite un fichier pcap projeté en mémoire.
+ * Types de lien acceptés : RAW (101), IPV4 (228), Ethernet (1) et Linux SLL (113).
+ */
+FileResult ProcessPcapFile(const std::string &filename, double chunkSize)
+{
+    FileResult result;
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return result;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 24)
+    {
+        close(fd);
+        return result;
+    }
+    std::size_t size = st.st_size;
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return result;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    const uint8_t *data = static_cast<const uint8_t *>(map);
+
+    // En-tête global : nombre magique (ordre des octets, résolution µs ou ns) et type de lien
+    uint32_t magic;
+    std::memcpy(&magic, data, sizeof(magic));
+    bool swapped = (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1);
+    bool nanos = (magic == 0xa1b23c4d || magic == 0x4d3cb2a1);
+    if (!swapped && !nanos && magic != 0xa1b2c3d4)
+    {
+        munmap(map, size);
+        return result;
+    }
+    uint32_t linkType = ReadU32(data + 20, swapped);
+    std::size_t linkHeader = 0;
+    switch (linkType)
+    {
+        case 101: case 228: linkHeader = 0; break;
+        case 1: linkHeader = 14; break;
+        case 113: linkHeader = 16; break;
+        default: munmap(map, size); return result;
+    }
+
+    std::map<std::pair<int, int64_t>, std::size_t> index;
+    std::size_t offset = 24;
+    while (offset + 16 <= size)
+    {
+        const uint8_t *rec = data + offset;
+        uint32_t tsSec = ReadU32(rec, swapped);
+        uint32_t tsFrac = ReadU32(rec + 4, swapped);
+        uint32_t inclLen = ReadU32(rec + 8, swapped);
+        offset += 16;
+        if (offset + inclLen > size)
+        {
+            break; // enregistrement tronqué en fin de fichier
+        }
+        const uint8_t *pkt = data + offset;
+        offset += inclLen;
+        ++result.packets;
+
+        // Ethernet / SLL : seul l'EtherType IPv4 nous intéresse
+        if ((linkType == 1 && (inclLen < 14 || ReadBe16(pkt + 12) != 0x0800)) ||
+            (linkType == 113 && (inclLen < 16 || ReadBe16(pkt + 14) != 0x0800)))
+        {
+            continue;
+        }
+        if (inclLen < linkHeader)
+        {
+            continue;
+        }
+        uint8_t proto;
+        uint16_t sport, dport;
+        if (!ParseIpv4Ports(pkt + linkHeader, inclLen - linkHeader, proto, sport, dport))
+        {
+            continue;
+        }
+        int label = PortsToLabel(sport, dport);
+        if (label == 0)
+        {
+            continue;
+        }
+
+        double time = tsSec + tsFrac / (nanos ? 1e9 : 1e6);
+        int64_t chunkIdx = MlChunkIndex(time, chunkSize);
+        auto key = std::make_pair(label, chunkIdx);
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+            it = index.emplace(key, result.chunks.size()).first;
+            result.chunks.emplace_back();
+            result.chunks.back().label = label;
+            result.chunks.back().chunkIdx = chunkIdx;
+        }
+        result.chunks[it->second].Add(time, inclLen, proto == 6);
+    }
+
+    munmap(map, size);
+    result.ok = true;
+    return result;
+}
+
+int main (int argc, char *argv[])
+{
+    std::string pattern = "trace-ml-ip-*.pcap";
+    std::string output = "dataset_ml_features.csv";
+    double chunkSize = ML_CHUNK_SIZE;
+    uint32_t threads = 0;
+    std::string profilesFile = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Extract the ML dataset features from the simulation-domestique IPv4 pcap traces (native pcap_to_dataset.py).");
+    cmd.AddValue("pattern", "Glob pattern of the pcap files", pattern);
+    cmd.AddValue("output", "Output CSV file", output);
+    cmd.AddValue("chunk", "Chunk (time window) size in seconds", chunkSize);
+    cmd.AddValue("threads", "Number of files processed in parallel (0 = all cores)", threads);
+    cmd.AddValue("profilesFile", "Extra application profiles of the simulation (--profilesFile), for the labels of their ports", profilesFile);
+    cmd.Parse(argc, argv);
+
+    std::string profilesError;
+    if (!profilesFile.empty() && !LoadAppProfiles(profilesFile, profilesError))
+    {
+        std::cout << "❌ Erreur : " << profilesError << std::endl;
+        return 1;
+    }
+
+    glob_t matches;
+    std::vector<std::string> files;
+    if (glob(pattern.c_str(), 0, nullptr, &matches) == 0)
+    {
+        files.assign(matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+    }
+    globfree(&matches);
+    if (files.empty())
+    {
+        std::cout << "❌ Erreur : Aucun fichier correspondant à '" << pattern << "' trouvé." << std::endl;
+        return 1;
+    }
+    std::cout << "Traitement de " << files.size() << " fichiers de traces IP..." << std::endl;
+
+    // Répartition dynamique des fichiers entre les threads ; chaque fichier a son propre résultat
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<uint32_t>(threads, files.size());
+    std::vector<FileResult> results(files.size());
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]() {
+            for (std::size_t i = next++; i < files.size(); i = next++)
+            {
+                results[i] = ProcessPcapFile(files[i], chunkSize);
+            }
+        });
+    }
+    for (std::thread &w : workers)
+    {
+        w.join();
+    }
+
+    uint64_t totalPackets = 0;
+    uint64_t chunkCounter = 0;
+    std::ofstream csv(output);
+    WriteMlFeaturesHeader(csv);
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        std::cout << " -> Lecture : " << files[i] << (results[i].ok ? "" : " (ignoré : pcap illisible)") << std::endl;
+        totalPackets += results[i].packets;
+        for (const ChunkAccumulator &c : results[i].chunks)
+        {
+            WriteMlFeaturesRow(csv, c);
+            ++chunkCounter;
+        }
+    }
+    csv.close();
+
+    if (chunkCounter == 0)
+    {
+        std::remove(output.c_str());
+        std::cout << "❌ Aucun chunk généré. Vérifiez que la simulation a tourné." << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Succès ! " << chunkCounter << " chunks générés dans '" << output << "' (" << totalPackets << " paquets lus)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,224 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Écriture asynchrone des traces (--asyncTraces de simulation-domestique, mode --doAsync de utils/perf/perf-io.cc).
+// Le thread du simulateur (unique producteur) copie chaque enregistrement dans un tampon circulaire sans verrou ;
+// un thread d'écriture (unique consommateur) vide le tampon par lots vers les fichiers.
+// Quand le tampon est plein, le producteur attend : ces attentes (contre-pression) sont comptées dans les statistiques.
+//
+// Format d'un enregistrement dans le tampon : numéro de fichier (32 bits), longueur (32 bits), puis les octets.
+//
+// Ce répertoire ne contient que des en-têtes partagés avec utils/ (chemin d'inclusion ajouté par utils/CMakeLists.txt) :
+// sans fichier .cc, ns-3 n'en fait pas un programme scratch.
+
+#ifndef SIMULATION_DOMESTIQUE_ASYNC_WRITER_H
+#define SIMULATION_DOMESTIQUE_ASYNC_WRITER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct AsyncWriterStats
+{
+    uint64_t records = 0;          // enregistrements écrits
+    uint64_t bytes = 0;            // octets utiles écrits
+    uint64_t stalls = 0;           // écritures qui ont dû attendre de la place dans le tampon
+    double stallSeconds = 0.0;     // temps passé par le producteur à attendre
+    uint64_t maxFill = 0;          // remplissage maximal du tampon (octets)
+    uint64_t batches = 0;          // lots vidés par le thread d'écriture
+};
+
+class AsyncTraceWriter
+{
+public:
+    // capacity : taille du tampon en octets, arrondie à la puissance de 2 supérieure ;
+    // maxFiles : nombre maximal de fichiers (la table n'est jamais réallouée pendant que le thread la lit)
+    explicit AsyncTraceWriter(std::size_t capacity = 16 << 20, std::size_t maxFiles = 4096)
+        : m_files(maxFiles, nullptr)
+    {
+        std::size_t size = 1 << 16;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_ring.resize(size);
+        m_mask = size - 1;
+        m_thread = std::thread(&AsyncTraceWriter::Drain, this);
+    }
+
+    ~AsyncTraceWriter()
+    {
+        Close();
+    }
+
+    AsyncTraceWriter(const AsyncTraceWriter &) = delete;
+    AsyncTraceWriter &operator=(const AsyncTraceWriter &) = delete;
+
+    /**
+     * @brief Ouvre un fichier de sortie (à appeler avant les écritures qui le visent).
+     * @return numéro du fichier, ou -1 si l'ouverture échoue.
+     */
+    int32_t Open(const std::string &filename)
+    {
+        std::size_t index = m_filesCount.load(std::memory_order_relaxed);
+        std::FILE *file = index < m_files.size() ? std::fopen(filename.c_str(), "wb") : nullptr;
+        if (!file)
+        {
+            return -1;
+        }
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        m_files[index] = file;
+        m_filesCount.store(index + 1, std::memory_order_release);
+        return (int32_t)index;
+    }
+
+    // Copie un enregistrement (deux morceaux concaténés, ex. en-tête + paquet) dans le tampon
+    void Write(int32_t file, const void *a, uint32_t aLen, const void *b = nullptr, uint32_t bLen = 0)
+    {
+        uint32_t header[2] = {(uint32_t)file, aLen + bLen};
+        uint64_t need = sizeof(header) + aLen + bLen;
+        if (need > m_ring.size())
+        {
+            std::abort(); // enregistrement plus grand que le tampon
+        }
+
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        if (head + need - tail > m_ring.size())
+        {
+            auto start = std::chrono::steady_clock::now();
+            ++m_stats.stalls;
+            while (head + need - (tail = m_tail.load(std::memory_order_acquire)) > m_ring.size())
+            {
+                std::this_thread::yield();
+            }
+            m_stats.stallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        CopyIn(head, header, sizeof(header));
+        CopyIn(head + sizeof(header), a, aLen);
+        if (bLen > 0)
+        {
+            CopyIn(head + sizeof(header) + aLen, b, bLen);
+        }
+        m_head.store(head + need, std::memory_order_release);
+
+        ++m_stats.records;
+        m_stats.bytes += aLen + bLen;
+        m_stats.maxFill = std::max<uint64_t>(m_stats.maxFill, head + need - tail);
+    }
+
+    // Vide le tampon, arrête le thread d'écriture et ferme les fichiers
+    void Close()
+    {
+        if (!m_thread.joinable())
+        {
+            return;
+        }
+        m_stop.store(true, std::memory_order_release);
+        m_thread.join();
+        for (std::size_t i = 0; i < m_filesCount.load(std::memory_order_relaxed); ++i)
+        {
+            std::fclose(m_files[i]);
+        }
+        m_filesCount.store(0, std::memory_order_relaxed);
+    }
+
+    // Statistiques (complètes après Close)
+    AsyncWriterStats GetStats() const
+    {
+        AsyncWriterStats stats = m_stats;
+        stats.batches = m_batches;
+        return stats;
+    }
+
+    std::size_t Capacity() const
+    {
+        return m_ring.size();
+    }
+
+private:
+    void CopyIn(uint64_t pos, const void *data, std::size_t len)
+    {
+        std::size_t offset = pos & m_mask;
+        std::size_t first = std::min(len, m_ring.size() - offset);
+        std::memcpy(&m_ring[offset], data, first);
+        std::memcpy(&m_ring[0], static_cast<const char *>(data) + first, len - first);
+    }
+
+    void CopyOut(uint64_t pos, void *data, std::size_t len) const
+    {
+        std::size_t offset = pos & m_mask;
+        std::size_t first = std::min(len, m_ring.size() - offset);
+        std::memcpy(data, &m_ring[offset], first);
+        std::memcpy(static_cast<char *>(data) + first, &m_ring[0], len - first);
+    }
+
+    // Thread d'écriture : traite tout ce qui est disponible, en libérant la place par huitièmes de tampon
+    void Drain()
+    {
+        std::vector<char> scratch;
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            bool stopping = m_stop.load(std::memory_order_acquire);
+            uint64_t head = m_head.load(std::memory_order_acquire);
+            if (head == tail)
+            {
+                if (stopping)
+                {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                continue;
+            }
+            std::size_t nFiles = m_filesCount.load(std::memory_order_acquire);
+            while (tail < head)
+            {
+                uint32_t header[2];
+                CopyOut(tail, header, sizeof(header));
+                std::size_t offset = (tail + sizeof(header)) & m_mask;
+                const char *data = &m_ring[offset];
+                if (offset + header[1] > m_ring.size())
+                {
+                    // Enregistrement à cheval sur la fin du tampon
+                    scratch.resize(header[1]);
+                    CopyOut(tail + sizeof(header), scratch.data(), header[1]);
+                    data = scratch.data();
+                }
+                if (header[0] < nFiles)
+                {
+                    std::fwrite(data, 1, header[1], m_files[header[0]]);
+                }
+                tail += sizeof(header) + header[1];
+                if (tail - m_tail.load(std::memory_order_relaxed) >= m_ring.size() / 8)
+                {
+                    m_tail.store(tail, std::memory_order_release);
+                }
+            }
+            m_tail.store(tail, std::memory_order_release);
+            ++m_batches;
+        }
+    }
+
+    std::vector<char> m_ring;
+    std::size_t m_mask = 0;
+    alignas(64) std::atomic<uint64_t> m_head{0};   // écrit par le producteur
+    alignas(64) std::atomic<uint64_t> m_tail{0};   // écrit par le thread d'écriture
+    alignas(64) std::atomic<bool> m_stop{false};
+    std::vector<std::FILE *> m_files;              // table de taille fixe, remplie par Open
+    std::atomic<std::size_t> m_filesCount{0};      // publié avant les écritures qui visent le fichier
+    AsyncWriterStats m_stats;                      // côté producteur
+    uint64_t m_batches = 0;                        // côté thread d'écriture
+    std::thread m_thread;
+};
+
+#endif // SIMULATION_DOMESTIQUE_ASYNC_WRITER_H
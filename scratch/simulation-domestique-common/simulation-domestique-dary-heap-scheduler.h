@@ -0,0 +1,176 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Ordonnanceur d'événements en tas 4-aire (ns3::DaryHeapScheduler), choisi par --SchedulerType=ns3::DaryHeapScheduler
+// dans simulation-domestique et comparé aux ordonnanceurs de ns-3 par utils/bench-scheduler --dary.
+//
+// Les événements (pointeur et clé, 24 octets) sont rangés par valeur dans un tableau contigu : ni allocation par
+// événement comme MapScheduler et ListScheduler, ni pointeur à suivre. Un tas 4-aire est deux fois moins profond
+// qu'un tas binaire et les quatre fils d'un nœud sont voisins en mémoire ; les tamisages déplacent un trou au lieu
+// d'échanger les éléments. Les clés sont comparées sur (horodatage 64 bits, uid), l'ordre de tous les ordonnanceurs.
+//
+// Remove (Simulator::Remove, rare : Cancel laisse l'événement dans la file) est paresseux : l'uid est mémorisé et
+// l'événement est écarté quand il atteint la racine, qui reste toujours un événement valide.
+
+#ifndef SIMULATION_DOMESTIQUE_DARY_HEAP_SCHEDULER_H
+#define SIMULATION_DOMESTIQUE_DARY_HEAP_SCHEDULER_H
+
+#include "ns3/abort.h"
+#include "ns3/scheduler.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Ordonnanceur en tas 4-aire sur tableau contigu, événements stockés par valeur.
+ */
+class DaryHeapScheduler : public Scheduler
+{
+public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::DaryHeapScheduler")
+                                .SetParent<Scheduler>()
+                                .SetGroupName("Core")
+                                .AddConstructor<DaryHeapScheduler>();
+        return tid;
+    }
+
+    DaryHeapScheduler()
+    {
+        m_heap.reserve(1024);
+    }
+
+    void Insert(const Event &ev) override
+    {
+        m_heap.push_back(ev);
+        SiftUp(m_heap.size() - 1);
+    }
+
+    bool IsEmpty() const override
+    {
+        return m_heap.empty();
+    }
+
+    Event PeekNext() const override
+    {
+        NS_ABORT_MSG_IF(m_heap.empty(), "DaryHeapScheduler::PeekNext sur une file vide");
+        return m_heap.front();
+    }
+
+    Event RemoveNext() override
+    {
+        NS_ABORT_MSG_IF(m_heap.empty(), "DaryHeapScheduler::RemoveNext sur une file vide");
+        Event next = m_heap.front();
+        PopFront();
+        PurgeFront();
+        return next;
+    }
+
+    void Remove(const Event &ev) override
+    {
+        if (!m_heap.empty() && m_heap.front().key.m_uid == ev.key.m_uid)
+        {
+            PopFront();
+        }
+        else
+        {
+            m_removed.insert(ev.key.m_uid);
+        }
+        PurgeFront();
+    }
+
+private:
+    static constexpr std::size_t ARITY = 4;
+
+    static bool Less(const EventKey &a, const EventKey &b)
+    {
+        return a.m_ts < b.m_ts || (a.m_ts == b.m_ts && a.m_uid < b.m_uid);
+    }
+
+    void SiftUp(std::size_t hole)
+    {
+        Event ev = m_heap[hole];
+        while (hole > 0)
+        {
+            std::size_t parent = (hole - 1) / ARITY;
+            if (!Less(ev.key, m_heap[parent].key))
+            {
+                break;
+            }
+            m_heap[hole] = m_heap[parent];
+            hole = parent;
+        }
+        m_heap[hole] = ev;
+    }
+
+    void SiftDown(std::size_t hole)
+    {
+        std::size_t size = m_heap.size();
+        Event ev = m_heap[hole];
+        while (true)
+        {
+            std::size_t first = hole * ARITY + 1;
+            if (first >= size)
+            {
+                break;
+            }
+            std::size_t last = first + ARITY < size ? first + ARITY : size;
+            std::size_t best = first;
+            for (std::size_t child = first + 1; child < last; ++child)
+            {
+                if (Less(m_heap[child].key, m_heap[best].key))
+                {
+                    best = child;
+                }
+            }
+            if (!Less(m_heap[best].key, ev.key))
+            {
+                break;
+            }
+            m_heap[hole] = m_heap[best];
+            hole = best;
+        }
+        m_heap[hole] = ev;
+    }
+
+    void PopFront()
+    {
+        m_heap.front() = m_heap.back();
+        m_heap.pop_back();
+        if (!m_heap.empty())
+        {
+            SiftDown(0);
+        }
+    }
+
+    // Écarte les événements retirés par Remove arrivés à la racine
+    void PurgeFront()
+    {
+        while (!m_removed.empty() && !m_heap.empty())
+        {
+            auto it = m_removed.find(m_heap.front().key.m_uid);
+            if (it == m_removed.end())
+            {
+                break;
+            }
+            m_removed.erase(it);
+            PopFront();
+        }
+    }
+
+    std::vector<Event> m_heap;
+    std::unordered_set<uint32_t> m_removed;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(DaryHeapScheduler);
+
+} // namespace ns3
+
+#endif // SIMULATION_DOMESTIQUE_DARY_HEAP_SCHEDULER_H
@@ -0,0 +1,295 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Ordonnanceur d'événements en file à échelle (ladder queue, Tang, Goh et Thng 2005), ns3::LadderScheduler,
+// choisi par --SchedulerType=ns3::LadderScheduler dans simulation-domestique et comparé aux ordonnanceurs de ns-3
+// par utils/bench-scheduler --ladder (préréglage --bimodal pour la distribution de la maison).
+//
+// La maison mêle des temporisateurs PHY/MAC de quelques microsecondes et des temporisateurs d'application de
+// plusieurs minutes (OffTime de 300 s des capteurs, 3600 s de la sonnette) : un calendrier à largeur de case fixe
+// (CalendarScheduler) y dégénère. La file à échelle n'a pas de largeur fixe :
+//   - Top    : événements lointains (date >= topStart), non triés ; seuls leurs min et max sont tenus.
+//   - Échelons : quand le reste est épuisé, Top est réparti dans l'échelon 0, dont la largeur de case vaut
+//             (max - min) / nombre d'événements. Une case de plus de LADDER_THRESHOLD événements est à son tour
+//             répartie dans un échelon plus fin, de largeur (fin de la case - min) / nombre d'événements, jusqu'à
+//             LADDER_MAX_RUNGS échelons : la largeur s'adapte à la densité locale des événements.
+//   - Bottom : la case courante, triée (date, uid) ; seul niveau trié, de taille bornée par LADDER_THRESHOLD
+//             tant que des échelons sont disponibles.
+// Chaque événement est déplacé un nombre borné de fois : insertion et retrait en O(1) amorti. Les événements sont
+// stockés par valeur, les vecteurs des cases sont réutilisés d'une répartition à l'autre.
+//
+// Remove (Simulator::Remove, rare) est paresseux : l'uid est mémorisé et l'événement écarté quand il atteint Bottom.
+// Bottom n'est jamais vide tant que la file contient un événement valide, ce qui rend PeekNext constant.
+
+#ifndef SIMULATION_DOMESTIQUE_LADDER_SCHEDULER_H
+#define SIMULATION_DOMESTIQUE_LADDER_SCHEDULER_H
+
+#include "ns3/abort.h"
+#include "ns3/scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Ordonnanceur en file à échelle : largeurs de case ajustées à la répartition des événements, O(1) amorti.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+    static constexpr std::size_t LADDER_THRESHOLD = 50; // événements au-delà desquels une case est raffinée
+    static constexpr std::size_t LADDER_MAX_RUNGS = 8;
+
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::LadderScheduler")
+                                .SetParent<Scheduler>()
+                                .SetGroupName("Core")
+                                .AddConstructor<LadderScheduler>();
+        return tid;
+    }
+
+    LadderScheduler()
+    {
+        m_rungs.resize(LADDER_MAX_RUNGS);
+    }
+
+    void Insert(const Event &ev) override
+    {
+        ++m_size;
+        uint64_t ts = ev.key.m_ts;
+        if (ts >= m_topStart)
+        {
+            if (m_top.empty())
+            {
+                m_topMin = m_topMax = ts;
+            }
+            m_topMin = std::min(m_topMin, ts);
+            m_topMax = std::max(m_topMax, ts);
+            m_top.push_back(ev);
+        }
+        else if (!InsertInRungs(ev))
+        {
+            InsertInBottom(ev);
+            if (m_bottom.size() > LADDER_THRESHOLD && m_nRungs < LADDER_MAX_RUNGS && m_bottom.front().key.m_ts > m_bottom.back().key.m_ts)
+            {
+                // Bottom trop long : il devient un échelon, borné par la case courante de l'échelon le plus fin
+                std::vector<Event> events;
+                events.swap(m_bottom);
+                SpawnRung(events, m_nRungs > 0 ? RungCurrent(m_rungs[m_nRungs - 1]) : m_topStart);
+                m_bottom.swap(events);
+                m_bottom.clear();
+            }
+        }
+        Prepare();
+    }
+
+    bool IsEmpty() const override
+    {
+        return m_size == 0;
+    }
+
+    Event PeekNext() const override
+    {
+        NS_ABORT_MSG_IF(m_bottom.empty(), "LadderScheduler::PeekNext sur une file vide");
+        return m_bottom.back();
+    }
+
+    Event RemoveNext() override
+    {
+        NS_ABORT_MSG_IF(m_bottom.empty(), "LadderScheduler::RemoveNext sur une file vide");
+        Event next = m_bottom.back();
+        m_bottom.pop_back();
+        --m_size;
+        Prepare();
+        return next;
+    }
+
+    void Remove(const Event &ev) override
+    {
+        --m_size;
+        if (!m_bottom.empty() && m_bottom.back().key.m_uid == ev.key.m_uid)
+        {
+            m_bottom.pop_back();
+        }
+        else
+        {
+            m_removed.insert(ev.key.m_uid);
+        }
+        Prepare();
+    }
+
+private:
+    // Échelon : case i = [start + i * width, start + (i + 1) * width), cases d'indice < current déjà vidées
+    struct Rung
+    {
+        uint64_t start = 0;
+        uint64_t width = 1;
+        std::size_t current = 0;
+        std::size_t bucketCount = 0;
+        std::vector<std::vector<Event>> buckets;
+    };
+
+    // Les clés sont rangées par ordre décroissant dans Bottom : le prochain événement est à la fin
+    static bool Greater(const Event &a, const Event &b)
+    {
+        return a.key.m_ts > b.key.m_ts || (a.key.m_ts == b.key.m_ts && a.key.m_uid > b.key.m_uid);
+    }
+
+    // Début de la première case non vidée : les événements de date supérieure relèvent de cet échelon
+    static uint64_t RungCurrent(const Rung &rung)
+    {
+        return rung.start + rung.current * rung.width;
+    }
+
+    bool InsertInRungs(const Event &ev)
+    {
+        for (std::size_t x = 0; x < m_nRungs; ++x)
+        {
+            Rung &rung = m_rungs[x];
+            if (ev.key.m_ts >= RungCurrent(rung))
+            {
+                rung.buckets[(ev.key.m_ts - rung.start) / rung.width].push_back(ev);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void InsertInBottom(const Event &ev)
+    {
+        m_bottom.insert(std::upper_bound(m_bottom.begin(), m_bottom.end(), ev, Greater), ev);
+    }
+
+    // Répartit events, de dates dans [min, end), dans un nouvel échelon ; events est vidé
+    void SpawnRung(std::vector<Event> &events, uint64_t end)
+    {
+        uint64_t min = events.front().key.m_ts;
+        for (const auto &ev : events)
+        {
+            min = std::min(min, ev.key.m_ts);
+        }
+        Rung &rung = m_rungs[m_nRungs++];
+        rung.start = min;
+        rung.width = (end - min) / events.size() + 1;
+        rung.current = 0;
+        rung.bucketCount = (end - min + rung.width - 1) / rung.width;
+        if (rung.buckets.size() < rung.bucketCount)
+        {
+            rung.buckets.resize(rung.bucketCount);
+        }
+        for (const auto &ev : events)
+        {
+            rung.buckets[(ev.key.m_ts - min) / rung.width].push_back(ev);
+        }
+        events.clear();
+    }
+
+    // Top est épuisé dans l'échelon 0 ; les insertions suivantes au-delà de son dernier événement vont dans Top
+    void TransferTop()
+    {
+        uint64_t end = m_topMax + 1;
+        std::vector<Event> events;
+        events.swap(m_top);
+        SpawnRung(events, end);
+        m_top.swap(events);
+        m_topStart = m_rungs[0].start + m_rungs[0].bucketCount * m_rungs[0].width;
+    }
+
+    // Remplit Bottom avec la prochaine case non vide, en raffinant les cases trop chargées
+    void NextBucket()
+    {
+        while (m_bottom.empty())
+        {
+            if (m_nRungs == 0)
+            {
+                TransferTop();
+            }
+            Rung &rung = m_rungs[m_nRungs - 1];
+            while (rung.current < rung.bucketCount && rung.buckets[rung.current].empty())
+            {
+                ++rung.current;
+            }
+            if (rung.current == rung.bucketCount)
+            {
+                --m_nRungs;
+                continue;
+            }
+            std::vector<Event> &bucket = rung.buckets[rung.current++];
+            uint64_t end = RungCurrent(rung);
+            auto [lo, hi] = std::minmax_element(bucket.begin(), bucket.end(), [](const Event &a, const Event &b) {
+                return a.key.m_ts < b.key.m_ts;
+            });
+            if (bucket.size() > LADDER_THRESHOLD && m_nRungs < LADDER_MAX_RUNGS && lo->key.m_ts < hi->key.m_ts)
+            {
+                SpawnRung(bucket, end);
+            }
+            else
+            {
+                m_bottom.swap(bucket);
+                std::sort(m_bottom.begin(), m_bottom.end(), Greater);
+            }
+        }
+    }
+
+    // Rétablit l'invariant : si la file n'est pas vide, le dernier élément de Bottom est le prochain événement valide
+    void Prepare()
+    {
+        if (m_size == 0)
+        {
+            m_top.clear();
+            m_bottom.clear();
+            for (std::size_t x = 0; x < m_nRungs; ++x)
+            {
+                for (std::size_t i = m_rungs[x].current; i < m_rungs[x].bucketCount; ++i)
+                {
+                    m_rungs[x].buckets[i].clear();
+                }
+            }
+            m_nRungs = 0;
+            m_topStart = 0;
+            m_removed.clear();
+            return;
+        }
+        while (true)
+        {
+            while (!m_removed.empty() && !m_bottom.empty())
+            {
+                auto it = m_removed.find(m_bottom.back().key.m_uid);
+                if (it == m_removed.end())
+                {
+                    break;
+                }
+                m_removed.erase(it);
+                m_bottom.pop_back();
+            }
+            if (!m_bottom.empty())
+            {
+                return;
+            }
+            NextBucket();
+        }
+    }
+
+    std::vector<Event> m_top;
+    uint64_t m_topStart = 0;
+    uint64_t m_topMin = 0;
+    uint64_t m_topMax = 0;
+    std::vector<Rung> m_rungs;
+    std::size_t m_nRungs = 0;
+    std::vector<Event> m_bottom;
+    std::unordered_set<uint32_t> m_removed;
+    std::size_t m_size = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+} // namespace ns3
+
+#endif // SIMULATION_DOMESTIQUE_LADDER_SCHEDULER_H
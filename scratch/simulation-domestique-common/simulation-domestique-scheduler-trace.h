@@ -0,0 +1,327 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Trace des opérations de l'ordonnanceur d'événements (--schedulerTrace de simulation-domestique),
+// rejouée par utils/bench-scheduler --replay=<trace> contre chacun des ordonnanceurs de ns-3.
+//
+// RecordingScheduler enveloppe l'ordonnanceur en vigueur (SchedulerType) et écrit chaque Insert, RemoveNext et Remove,
+// de la première insertion à la destruction du simulateur. Format du fichier : l'en-tête "NS3SCHT1", puis un octet
+// de type par opération suivi d'entiers LEB128 (7 bits par octet) :
+//   INSERT      : ts - now, uid - uid de l'insertion précédente (zigzag), contexte + 1 (0 : sans contexte)
+//   REMOVE_NEXT : ts - now (avance de l'horloge) ; l'événement retiré est fixé par la clé (ts, uid), le même pour
+//                 tous les ordonnanceurs, et son horodatage permet de vérifier le rejeu
+//   REMOVE      : ts - now, uid, contexte + 1
+// now est l'horodatage du dernier événement retiré : une insertion tient d'ordinaire en 4 à 9 octets, un retrait en 1 à 5.
+
+#ifndef SIMULATION_DOMESTIQUE_SCHEDULER_TRACE_H
+#define SIMULATION_DOMESTIQUE_SCHEDULER_TRACE_H
+
+#include "ns3/abort.h"
+#include "ns3/object-factory.h"
+#include "ns3/scheduler.h"
+#include "ns3/string.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum SchedulerTraceOp : uint8_t
+{
+    TRACE_INSERT = 0,
+    TRACE_REMOVE_NEXT = 1,
+    TRACE_REMOVE = 2
+};
+
+// Opération décodée : type et clé de l'événement (horodatage absolu ; pour REMOVE_NEXT, seul m_ts est connu)
+struct SchedulerTraceRecord
+{
+    ns3::Scheduler::EventKey key;
+    uint8_t op;
+};
+
+const char SCHEDULER_TRACE_MAGIC[8] = {'N', 'S', '3', 'S', 'C', 'H', 'T', '1'};
+
+// Écriture tamponnée de la trace (un fwrite par Mo)
+class SchedulerTraceWriter
+{
+public:
+    ~SchedulerTraceWriter()
+    {
+        Close();
+    }
+
+    bool Open(const std::string &filename)
+    {
+        Close();
+        m_file = std::fopen(filename.c_str(), "wb");
+        if (!m_file)
+        {
+            return false;
+        }
+        m_buffer.reserve(1 << 20);
+        m_buffer.insert(m_buffer.end(), SCHEDULER_TRACE_MAGIC, SCHEDULER_TRACE_MAGIC + sizeof(SCHEDULER_TRACE_MAGIC));
+        m_now = 0;
+        m_lastUid = 0;
+        return true;
+    }
+
+    bool IsOpen() const
+    {
+        return m_file != nullptr;
+    }
+
+    void Insert(const ns3::Scheduler::EventKey &key)
+    {
+        m_buffer.push_back(TRACE_INSERT);
+        PutVarint(key.m_ts - m_now);
+        int64_t uidDelta = (int64_t)key.m_uid - (int64_t)m_lastUid;
+        PutVarint(((uint64_t)uidDelta << 1) ^ (uint64_t)(uidDelta >> 63));
+        PutVarint((uint32_t)(key.m_context + 1));
+        m_lastUid = key.m_uid;
+        Flush(false);
+    }
+
+    void RemoveNext(const ns3::Scheduler::EventKey &key)
+    {
+        m_buffer.push_back(TRACE_REMOVE_NEXT);
+        PutVarint(key.m_ts - m_now);
+        m_now = key.m_ts;
+        Flush(false);
+    }
+
+    void Remove(const ns3::Scheduler::EventKey &key)
+    {
+        m_buffer.push_back(TRACE_REMOVE);
+        PutVarint(key.m_ts - m_now);
+        PutVarint(key.m_uid);
+        PutVarint((uint32_t)(key.m_context + 1));
+        Flush(false);
+    }
+
+    void Close()
+    {
+        if (m_file)
+        {
+            Flush(true);
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    uint64_t GetBytes() const
+    {
+        return m_bytes + m_buffer.size();
+    }
+
+private:
+    void PutVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            m_buffer.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        m_buffer.push_back((uint8_t)value);
+    }
+
+    void Flush(bool force)
+    {
+        if (m_file && (force || m_buffer.size() >= (1 << 20) - 32))
+        {
+            std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+            m_bytes += m_buffer.size();
+            m_buffer.clear();
+        }
+    }
+
+    std::FILE *m_file = nullptr;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_bytes = 0;
+    uint64_t m_now = 0;
+    uint32_t m_lastUid = 0;
+};
+
+/**
+ * @brief Lit et décode une trace entière (24 octets par opération en mémoire), pour que le rejeu ne mesure que l'ordonnanceur.
+ * @return false si le fichier est illisible, n'est pas une trace ou est tronqué, avec la raison dans error.
+ */
+inline bool ReadSchedulerTrace(const std::string &filename, std::vector<SchedulerTraceRecord> &records, std::string &error)
+{
+    std::FILE *file = std::fopen(filename.c_str(), "rb");
+    if (!file)
+    {
+        error = "impossible d'ouvrir " + filename;
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t chunk[1 << 16];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    std::fclose(file);
+    if (data.size() < sizeof(SCHEDULER_TRACE_MAGIC) || std::memcmp(data.data(), SCHEDULER_TRACE_MAGIC, sizeof(SCHEDULER_TRACE_MAGIC)) != 0)
+    {
+        error = filename + " n'est pas une trace d'ordonnanceur";
+        return false;
+    }
+
+    std::size_t pos = sizeof(SCHEDULER_TRACE_MAGIC);
+    bool truncated = false;
+    auto varint = [&data, &pos, &truncated]() {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            if (pos >= data.size())
+            {
+                truncated = true;
+                return value;
+            }
+            uint8_t byte = data[pos++];
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+        return value;
+    };
+
+    records.clear();
+    uint64_t now = 0;
+    uint32_t lastUid = 0;
+    while (pos < data.size() && !truncated)
+    {
+        SchedulerTraceRecord r;
+        r.op = data[pos++];
+        r.key.m_ts = now;
+        r.key.m_uid = 0;
+        r.key.m_context = 0;
+        if (r.op == TRACE_INSERT)
+        {
+            r.key.m_ts = now + varint();
+            uint64_t zigzag = varint();
+            lastUid = (uint32_t)((int64_t)lastUid + (int64_t)((zigzag >> 1) ^ (~(zigzag & 1) + 1)));
+            r.key.m_uid = lastUid;
+            r.key.m_context = (uint32_t)varint() - 1;
+        }
+        else if (r.op == TRACE_REMOVE)
+        {
+            r.key.m_ts = now + varint();
+            r.key.m_uid = (uint32_t)varint();
+            r.key.m_context = (uint32_t)varint() - 1;
+        }
+        else if (r.op == TRACE_REMOVE_NEXT)
+        {
+            r.key.m_ts = now + varint();
+            now = r.key.m_ts;
+        }
+        else
+        {
+            error = filename + " : opération inconnue à l'octet " + std::to_string(pos - 1);
+            return false;
+        }
+        records.push_back(r);
+    }
+    if (truncated)
+    {
+        error = filename + " : trace tronquée";
+        return false;
+    }
+    return true;
+}
+
+namespace ns3
+{
+
+/**
+ * @brief Ordonnanceur d'enregistrement : délègue chaque opération à l'ordonnanceur enveloppé (attribut Scheduler)
+ * et l'écrit dans la trace (attribut TraceFile).
+ */
+class RecordingScheduler : public Scheduler
+{
+public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::RecordingScheduler")
+                .SetParent<Scheduler>()
+                .SetGroupName("Core")
+                .AddConstructor<RecordingScheduler>()
+                .AddAttribute("Scheduler",
+                              "TypeId name of the scheduler that actually stores the events",
+                              StringValue("ns3::MapScheduler"),
+                              MakeStringAccessor(&RecordingScheduler::SetScheduler),
+                              MakeStringChecker())
+                .AddAttribute("TraceFile",
+                              "Binary file receiving the Insert, RemoveNext and Remove operations",
+                              StringValue(""),
+                              MakeStringAccessor(&RecordingScheduler::SetTraceFile),
+                              MakeStringChecker());
+        return tid;
+    }
+
+    void Insert(const Event &ev) override
+    {
+        m_writer.Insert(ev.key);
+        m_scheduler->Insert(ev);
+    }
+
+    bool IsEmpty() const override
+    {
+        return m_scheduler->IsEmpty();
+    }
+
+    Event PeekNext() const override
+    {
+        return m_scheduler->PeekNext();
+    }
+
+    Event RemoveNext() override
+    {
+        Event ev = m_scheduler->RemoveNext();
+        m_writer.RemoveNext(ev.key);
+        return ev;
+    }
+
+    void Remove(const Event &ev) override
+    {
+        m_writer.Remove(ev.key);
+        m_scheduler->Remove(ev);
+    }
+
+private:
+    void SetScheduler(const std::string &typeName)
+    {
+        NS_ABORT_MSG_IF(typeName == "ns3::RecordingScheduler", "RecordingScheduler ne peut pas s'envelopper lui-même");
+        ObjectFactory factory;
+        factory.SetTypeId(typeName);
+        m_scheduler = factory.Create<Scheduler>();
+    }
+
+    void SetTraceFile(const std::string &filename)
+    {
+        NS_ABORT_MSG_IF(!filename.empty() && !m_writer.Open(filename), "Impossible de créer la trace d'ordonnanceur " << filename);
+    }
+
+    void DoDispose() override
+    {
+        m_writer.Close();
+        m_scheduler = nullptr;
+        Scheduler::DoDispose();
+    }
+
+    Ptr<Scheduler> m_scheduler;
+    SchedulerTraceWriter m_writer;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(RecordingScheduler);
+
+} // namespace ns3
+
+#endif // SIMULATION_DOMESTIQUE_SCHEDULER_TRACE_H
@@ -0,0 +1,174 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Format binaire en colonnes des métriques de simulation-domestique (écrit avec --metricsFormat=binary,
+// relu par scratch/metrics-reader.cc). Il remplace le XML des résultats et celui de FlowMonitor :
+// seules les sommes brutes sont stockées, les moyennes (perte, délai, gigue, débit) se recalculent à la lecture.
+//
+// Disposition du fichier (ordre des octets de la machine, little-endian sur les cibles usuelles) :
+//   MetricsFileHeader (32 octets)
+//   table des sinks : une colonne contiguë par champ de MetricsSinkColumns, sinkCount valeurs chacune
+//   table des flux  : une colonne contiguë par champ de MetricsFlowColumns, flowCount valeurs chacune
+// Les temps sont en nanosecondes.
+
+#ifndef SIMULATION_DOMESTIQUE_METRICS_H
+#define SIMULATION_DOMESTIQUE_METRICS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+const char METRICS_MAGIC[4] = {'S', 'D', 'M', 'B'};
+const uint16_t METRICS_VERSION = 1;
+
+struct MetricsFileHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t sinkCount;
+    uint32_t flowCount;
+    double durationSeconds;
+    uint64_t reserved;
+};
+static_assert(sizeof(MetricsFileHeader) == 32, "MetricsFileHeader doit faire 32 octets");
+
+// Métriques par sink (récepteur) : octets reçus par l'application et statistiques FlowMonitor agrégées
+struct MetricsSinkColumns
+{
+    std::vector<uint32_t> nodeId;
+    std::vector<uint16_t> port;
+    std::vector<uint64_t> sinkRxBytes;
+    std::vector<uint64_t> txPackets;
+    std::vector<uint64_t> rxPackets;
+    std::vector<uint64_t> lostPackets;
+    std::vector<uint64_t> txBytes;
+    std::vector<uint64_t> rxBytes;
+    std::vector<int64_t> delaySumNs;
+    std::vector<int64_t> jitterSumNs;
+
+    std::size_t Size() const
+    {
+        return nodeId.size();
+    }
+};
+
+// Statistiques FlowMonitor par flux (sans les histogrammes ni les sondes du XML de FlowMonitor)
+struct MetricsFlowColumns
+{
+    std::vector<uint32_t> flowId;
+    std::vector<uint32_t> srcAddr;
+    std::vector<uint32_t> dstAddr;
+    std::vector<uint16_t> srcPort;
+    std::vector<uint16_t> dstPort;
+    std::vector<uint8_t> protocol;
+    std::vector<uint64_t> txPackets;
+    std::vector<uint64_t> rxPackets;
+    std::vector<uint64_t> lostPackets;
+    std::vector<uint64_t> txBytes;
+    std::vector<uint64_t> rxBytes;
+    std::vector<int64_t> delaySumNs;
+    std::vector<int64_t> jitterSumNs;
+    std::vector<int64_t> timeFirstTxNs;
+    std::vector<int64_t> timeLastTxNs;
+    std::vector<int64_t> timeFirstRxNs;
+    std::vector<int64_t> timeLastRxNs;
+
+    std::size_t Size() const
+    {
+        return flowId.size();
+    }
+};
+
+template <typename T>
+inline bool WriteMetricsColumn(std::FILE *file, const std::vector<T> &column)
+{
+    return column.empty() || std::fwrite(column.data(), sizeof(T), column.size(), file) == column.size();
+}
+
+template <typename T>
+inline bool ReadMetricsColumn(std::FILE *file, std::vector<T> &column, uint32_t count)
+{
+    column.resize(count);
+    return count == 0 || std::fread(column.data(), sizeof(T), count, file) == count;
+}
+
+// Applique op à chaque colonne, dans l'ordre du fichier (Sinks : MetricsSinkColumns, éventuellement const)
+template <typename Sinks, typename Op>
+inline bool ForEachSinkColumn(Sinks &s, Op op)
+{
+    return op(s.nodeId) && op(s.port) && op(s.sinkRxBytes) && op(s.txPackets) && op(s.rxPackets) &&
+           op(s.lostPackets) && op(s.txBytes) && op(s.rxBytes) && op(s.delaySumNs) && op(s.jitterSumNs);
+}
+
+// Idem pour Flows : MetricsFlowColumns, éventuellement const
+template <typename Flows, typename Op>
+inline bool ForEachFlowColumn(Flows &f, Op op)
+{
+    return op(f.flowId) && op(f.srcAddr) && op(f.dstAddr) && op(f.srcPort) && op(f.dstPort) && op(f.protocol) &&
+           op(f.txPackets) && op(f.rxPackets) && op(f.lostPackets) && op(f.txBytes) && op(f.rxBytes) &&
+           op(f.delaySumNs) && op(f.jitterSumNs) && op(f.timeFirstTxNs) && op(f.timeLastTxNs) &&
+           op(f.timeFirstRxNs) && op(f.timeLastRxNs);
+}
+
+/**
+ * @brief Écrit les tables des sinks et des flux dans filename.
+ * Le fichier est écrit colonne par colonne à travers un tampon de 1 Mo (une écriture par colonne, sans vidage par ligne).
+ * @return false en cas d'erreur d'ouverture ou d'écriture.
+ */
+inline bool WriteBinaryMetrics(const std::string &filename, double durationSeconds, const MetricsSinkColumns &sinks, const MetricsFlowColumns &flows)
+{
+    std::FILE *file = std::fopen(filename.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    MetricsFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, METRICS_MAGIC, sizeof(header.magic));
+    header.version = METRICS_VERSION;
+    header.headerSize = sizeof(MetricsFileHeader);
+    header.sinkCount = static_cast<uint32_t>(sinks.Size());
+    header.flowCount = static_cast<uint32_t>(flows.Size());
+    header.durationSeconds = durationSeconds;
+
+    auto write = [file](const auto &column) { return WriteMetricsColumn(file, column); };
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 && ForEachSinkColumn(sinks, write) &&
+              ForEachFlowColumn(flows, write);
+    return (std::fclose(file) == 0) && ok;
+}
+
+/**
+ * @brief Relit un fichier écrit par WriteBinaryMetrics.
+ * @return false si le fichier est absent, tronqué ou d'un autre format/version.
+ */
+inline bool ReadBinaryMetrics(const std::string &filename, double &durationSeconds, MetricsSinkColumns &sinks, MetricsFlowColumns &flows)
+{
+    std::FILE *file = std::fopen(filename.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    MetricsFileHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::memcmp(header.magic, METRICS_MAGIC, sizeof(header.magic)) == 0 &&
+              header.version == METRICS_VERSION && header.headerSize == sizeof(MetricsFileHeader);
+    if (ok)
+    {
+        durationSeconds = header.durationSeconds;
+        ok = ForEachSinkColumn(sinks, [file, &header](auto &column) { return ReadMetricsColumn(file, column, header.sinkCount); }) &&
+             ForEachFlowColumn(flows, [file, &header](auto &column) { return ReadMetricsColumn(file, column, header.flowCount); });
+    }
+    std::fclose(file);
+    return ok;
+}
+
+#endif // SIMULATION_DOMESTIQUE_METRICS_H
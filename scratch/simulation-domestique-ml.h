@@ -0,0 +1,165 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Caractéristiques ML du dataset (dataset_ml_features.csv) communes à l'extraction hors ligne
+// (scratch/pcap-to-dataset.cc, à partir des traces pcap) et à l'extraction en ligne de
+// simulation-domestique (--enableMlFeatures, sans trace pcap).
+// Schéma : LABEL, CHUNK_ID, NB_PAQUETS, VOL_BYTES, PROTO_TCP_RATIO, IAT_MEAN, IAT_STD,
+// une ligne par (label, fenêtre de CHUNK_SIZE secondes) et par trace (nœud, interface).
+
+#ifndef SIMULATION_DOMESTIQUE_ML_H
+#define SIMULATION_DOMESTIQUE_ML_H
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+
+#include "simulation-domestique-profiles.h"
+
+const double ML_CHUNK_SIZE = 5.0;
+
+// LABEL d'un port d'après les profils d'application (pcap_to_dataset.py lit les mêmes, dans default_profiles.txt
+// et --profiles) ; 0 si le port n'est pas celui d'un flux étudié
+inline int PortToLabel(uint16_t port)
+{
+    return ProfileLabel(port);
+}
+
+// Le port destination est prioritaire sur le port source ; 0 si le paquet n'est pas d'un flux étudié
+inline int PortsToLabel(uint16_t sport, uint16_t dport)
+{
+    int label = PortToLabel(dport);
+    return label != 0 ? label : PortToLabel(sport);
+}
+
+inline uint16_t ReadBe16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Lit protocole et ports d'un paquet commençant par un en-tête IPv4.
+ * Comme scapy, les ports ne sont lisibles que dans le premier fragment d'un datagramme TCP ou UDP.
+ * @return false si ce n'est pas un paquet IPv4 TCP/UDP complet jusqu'aux ports.
+ */
+inline bool ParseIpv4Ports(const uint8_t *ip, std::size_t len, uint8_t &proto, uint16_t &sport, uint16_t &dport)
+{
+    if (len < 20 || (ip[0] >> 4) != 4)
+    {
+        return false;
+    }
+    std::size_t ihl = (ip[0] & 0x0f) * 4;
+    proto = ip[9];
+    uint16_t fragOffset = ReadBe16(ip + 6) & 0x1fff;
+    if ((proto != 6 && proto != 17) || fragOffset != 0 || ihl < 20 || len < ihl + 4)
+    {
+        return false;
+    }
+    sport = ReadBe16(ip + ihl);
+    dport = ReadBe16(ip + ihl + 2);
+    return true;
+}
+
+// Indice de fenêtre d'un instant (comme int(ip.time // CHUNK_SIZE))
+inline int64_t MlChunkIndex(double time, double chunkSize)
+{
+    return (int64_t)std::floor(time / chunkSize);
+}
+
+// Accumulateur d'un (label, chunk) : compteurs et moyenne/variance en ligne des inter-arrivées
+struct ChunkAccumulator
+{
+    int label = 0;
+    int64_t chunkIdx = 0;
+    uint64_t count = 0;
+    uint64_t vol = 0;
+    uint64_t tcpCount = 0;
+    double lastTime = 0.0;
+    uint64_t nDiffs = 0;
+    double iatMean = 0.0;
+    double iatM2 = 0.0;
+
+    void Add(double time, uint32_t len, bool tcp)
+    {
+        if (count > 0)
+        {
+            // Les horodatages d'une trace ns-3 sont croissants : les écarts successifs sont ceux des temps triés
+            double diff = time - lastTime;
+            ++nDiffs;
+            double deltaPre = diff - iatMean;
+            iatMean += deltaPre / nDiffs;
+            iatM2 += deltaPre * (diff - iatMean);
+        }
+        lastTime = time;
+        ++count;
+        vol += len;
+        tcpCount += tcp ? 1 : 0;
+    }
+
+    // Écart-type de population, comme la « variance simple » du script Python
+    double IatStd() const
+    {
+        return nDiffs > 0 ? std::sqrt(iatM2 / nDiffs) : 0.0;
+    }
+};
+
+// Écrit un flottant comme repr() de Python (plus courte écriture exacte, ".0" pour les entiers, exposant hors [1e-4, 1e16[)
+inline std::string PyFloat(double value)
+{
+    if (value == 0.0)
+    {
+        return std::signbit(value) ? "-0.0" : "0.0";
+    }
+    char buf[64];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific);
+    std::string sci(buf, res.ptr);
+    std::size_t e = sci.find('e');
+    std::string mantissa = sci.substr(0, e);
+    int exponent = std::stoi(sci.substr(e + 1));
+    bool negative = mantissa[0] == '-';
+    std::string digits;
+    for (char c : mantissa)
+    {
+        if (c >= '0' && c <= '9') digits += c;
+    }
+
+    std::string out = negative ? "-" : "";
+    if (exponent < -4 || exponent >= 16)
+    {
+        out += digits.substr(0, 1);
+        if (digits.size() > 1) out += "." + digits.substr(1);
+        char expBuf[16];
+        std::snprintf(expBuf, sizeof(expBuf), "e%c%02d", exponent < 0 ? '-' : '+', std::abs(exponent));
+        return out + expBuf;
+    }
+    if (exponent < 0)
+    {
+        return out + "0." + std::string(-exponent - 1, '0') + digits;
+    }
+    if ((int)digits.size() <= exponent + 1)
+    {
+        return out + digits + std::string(exponent + 1 - digits.size(), '0') + ".0";
+    }
+    return out + digits.substr(0, exponent + 1) + "." + digits.substr(exponent + 1);
+}
+
+// En-tête et lignes du CSV, avec les fins de ligne "\r\n" du module csv de Python
+inline void WriteMlFeaturesHeader(std::ostream &out)
+{
+    out << "LABEL,CHUNK_ID,NB_PAQUETS,VOL_BYTES,PROTO_TCP_RATIO,IAT_MEAN,IAT_STD\r\n";
+}
+
+inline void WriteMlFeaturesRow(std::ostream &out, const ChunkAccumulator &c)
+{
+    out << c.label << ",chunk_" << c.chunkIdx << "," << c.count << "," << c.vol << ","
+        << PyFloat((double)c.tcpCount / c.count) << "," << PyFloat(c.nDiffs > 0 ? c.iatMean : 0.0) << ","
+        << PyFloat(c.IatStd()) << "\r\n";
+}
+
+#endif // SIMULATION_DOMESTIQUE_ML_H
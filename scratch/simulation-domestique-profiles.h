@@ -0,0 +1,604 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Profils d'application des équipements de simulation-domestique.
+// Une table constexpr décrit les dix types de la maison de référence (clé du foyer, effectif, heure de début)
+// et leurs flux (port, modèle de trafic, protocole, sens, paramètres, nom dans les métriques, LABEL du dataset ML).
+// Elle peut être complétée à l'exécution par un fichier de profils (--profilesFile), au format :
+//
+//   # commentaire
+//   profile key=thermostat count=20 start=random          (start=random | uniform:min:max | fixed:t)
+//   flow port=9101 name=Thermostat label=11 model=udp interval=60 packetSize=64 maxPackets=10000
+//   flow port=9102 name=Flux_Descendant model=onoff protocol=tcp direction=down rate=2Mbps on=10 off=1 packetSize=1400
+//
+// Chaque ligne flow appartient au dernier profile. Clés d'un flux : port, name, source (nom de la source, par défaut name),
+// label (0 = hors dataset), model (udp | onoff | bulk), protocol (udp | tcp), direction (up : équipement -> serveur,
+// down : serveur -> équipement), packetSize, interval (s, ou min:max tiré une fois par équipement), rate (bps, suffixes k, M, G),
+// on, off (s), maxPackets, maxBytes. Le même fichier est lu par demoPerformance.py, pcap_to_dataset.py et train_classifier.py.
+// La table intégrée est exportée dans ce format par WriteAppProfiles (default_profiles.txt, --exportProfiles), d'où ces scripts
+// tirent les noms et LABEL des ports de la maison de référence.
+//
+// Ce fichier ne dépend pas de ns-3 (il est aussi utilisé par pcap-to-dataset) ; l'installation des applications est faite par simulation-domestique.
+
+#ifndef SIMULATION_DOMESTIQUE_PROFILES_H
+#define SIMULATION_DOMESTIQUE_PROFILES_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum class TrafficModel : uint8_t
+{
+    UDP_CBR,   // UdpClient : un paquet toutes les interval secondes
+    ON_OFF,    // OnOffApplication : périodes on/off constantes, débit rate pendant les périodes on
+    BULK       // BulkSendApplication (TCP) : envoi au plus vite de maxBytes octets
+};
+
+enum class StartMode : uint8_t
+{
+    RANDOM,    // heure de début commune aux équipements, tirée dans [0, 5] s (debutAleatoire)
+    UNIFORM,   // tirée une fois par équipement dans [startMin, startMax]
+    FIXED      // startMin
+};
+
+struct FlowProfile
+{
+    uint16_t port = 0;
+    const char *name = "";          // type d'application dans les métriques (console, XML, CSV, séries temporelles)
+    const char *sourceName = "";    // nom de la source de trafic
+    uint8_t label = 0;              // LABEL du dataset ML, 0 : flux hors dataset
+    TrafficModel model = TrafficModel::UDP_CBR;
+    bool tcp = false;
+    bool downlink = false;          // source sur le serveur, sink sur l'équipement
+    uint32_t packetSize = 512;
+    double intervalMin = 1.0;       // UDP_CBR : intervalle entre paquets (s), tiré une fois par équipement si intervalMin < intervalMax
+    double intervalMax = 1.0;
+    uint64_t dataRateBps = 0;       // ON_OFF
+    double onTime = 1.0;            // ON_OFF (s)
+    double offTime = 0.0;
+    uint32_t maxPackets = 0;        // UDP_CBR (0 : illimité)
+    uint64_t maxBytes = 0;          // BULK (0 : illimité)
+};
+
+// Trois flux au plus par équipement : les applications d'un équipement tirent dans STREAM_APPLICATIONS (4 flux aléatoires chacune)
+const uint32_t MAX_FLOWS_PER_PROFILE = 3;
+
+struct AppProfile
+{
+    const char *key = "";           // clé de la description du foyer (--mix)
+    uint32_t defaultCount = 0;      // effectif de la maison de référence
+    StartMode start = StartMode::RANDOM;
+    double startMin = 0.0;
+    double startMax = 0.0;
+    uint32_t flowCount = 0;
+    FlowProfile flows[MAX_FLOWS_PER_PROFILE] = {};
+
+    // Au moins un tirage par équipement (heure de début ou intervalle)
+    bool HasParameterDraw() const
+    {
+        bool draw = start == StartMode::UNIFORM;
+        for (uint32_t f = 0; f < flowCount; ++f)
+        {
+            draw = draw || flows[f].intervalMin < flows[f].intervalMax;
+        }
+        return draw;
+    }
+};
+
+constexpr FlowProfile UdpCbrFlow(uint16_t port, const char *name, const char *sourceName, uint8_t label, uint32_t packetSize,
+                                 double intervalMin, double intervalMax, uint32_t maxPackets)
+{
+    FlowProfile f;
+    f.port = port;
+    f.name = name;
+    f.sourceName = sourceName;
+    f.label = label;
+    f.model = TrafficModel::UDP_CBR;
+    f.packetSize = packetSize;
+    f.intervalMin = intervalMin;
+    f.intervalMax = intervalMax;
+    f.maxPackets = maxPackets;
+    return f;
+}
+
+constexpr FlowProfile OnOffFlow(uint16_t port, const char *name, const char *sourceName, uint8_t label, bool tcp, bool downlink,
+                                uint32_t packetSize, uint64_t dataRateBps, double onTime, double offTime)
+{
+    FlowProfile f;
+    f.port = port;
+    f.name = name;
+    f.sourceName = sourceName;
+    f.label = label;
+    f.model = TrafficModel::ON_OFF;
+    f.tcp = tcp;
+    f.downlink = downlink;
+    f.packetSize = packetSize;
+    f.dataRateBps = dataRateBps;
+    f.onTime = onTime;
+    f.offTime = offTime;
+    return f;
+}
+
+constexpr FlowProfile BulkFlow(uint16_t port, const char *name, const char *sourceName, uint8_t label, uint64_t maxBytes)
+{
+    FlowProfile f;
+    f.port = port;
+    f.name = name;
+    f.sourceName = sourceName;
+    f.label = label;
+    f.model = TrafficModel::BULK;
+    f.tcp = true;
+    f.downlink = true;
+    f.maxBytes = maxBytes;
+    return f;
+}
+
+constexpr AppProfile MakeProfile(const char *key, uint32_t defaultCount, FlowProfile first, FlowProfile second = FlowProfile(),
+                                 StartMode start = StartMode::RANDOM, double startMin = 0.0, double startMax = 0.0)
+{
+    AppProfile p;
+    p.key = key;
+    p.defaultCount = defaultCount;
+    p.start = start;
+    p.startMin = startMin;
+    p.startMax = startMax;
+    p.flows[0] = first;
+    p.flows[1] = second;
+    p.flowCount = second.port != 0 ? 2 : 1;
+    return p;
+}
+
+// Maison de référence : 5/10/3/2/4/4/1/1/1/1, soit 32 équipements. L'ordre du tableau fixe l'ordre des serveurs
+// (serverNodes.Get(i)) et la forme positionnelle de --mix ; les LABEL suivent PORT_TO_LABEL de pcap_to_dataset.py.
+inline constexpr AppProfile BUILTIN_PROFILES[] = {
+    MakeProfile("camera", 5, UdpCbrFlow(9001, "Caméra", "Caméra", 1, 1200, 0.05, 0.05, 100000)),
+    MakeProfile("sensor", 10, OnOffFlow(9002, "Capteur", "Capteur", 2, true, false, 80, 50000, 0.5, 300.0)),
+    MakeProfile("voice", 3, OnOffFlow(9003, "AssistantVocal", "AssistantVocal", 3, true, false, 500, 150000, 2.0, 60.0)),
+    MakeProfile("download", 2, BulkFlow(9004, "Téléchargement", "Téléchargement-Serveur", 4, 100000000)),
+    MakeProfile("voip", 4,
+                OnOffFlow(9005, "VoIP_LiaisonMontante", "VoIP_Montante_Client", 5, false, false, 180, 72000, 1.0, 0.0),
+                OnOffFlow(9006, "VoIP_LiaisonDescendante", "VoIP_Descendante_Server", 6, false, true, 180, 72000, 1.0, 0.0)),
+    MakeProfile("domotics", 4, UdpCbrFlow(9007, "Domotique", "Domotique", 7, 64, 10.0, 30.0, 10000)),
+    MakeProfile("streaming", 1, OnOffFlow(9008, "Diffusion", "Diffusion-Serveur", 8, true, true, 1400, 2000000, 10.0, 1.0)),
+    MakeProfile("doorbell", 1, OnOffFlow(9009, "Sonnette", "Sonnette", 9, true, false, 250, 100000, 1.0, 3600.0), FlowProfile(),
+                StartMode::UNIFORM, 0.0, 180.0),
+    MakeProfile("firmware", 1, BulkFlow(9010, "MiseAJourFirmware", "MiseAJourFirmware-Serveur", 10, 500000000), FlowProfile(),
+                StartMode::FIXED, 300.0),
+    MakeProfile("monitoring", 1, UdpCbrFlow(9011, "Supervision", "Supervision", 0, 300, 2.0, 2.0, 10000)),
+};
+
+// Un port identifie un flux (sink, nom des métriques, LABEL) : il ne peut appartenir qu'à un seul profil
+constexpr bool BuiltinPortsAreUnique()
+{
+    const uint32_t n = sizeof(BUILTIN_PROFILES) / sizeof(BUILTIN_PROFILES[0]);
+    for (uint32_t a = 0; a < n * MAX_FLOWS_PER_PROFILE; ++a)
+    {
+        const FlowProfile &fa = BUILTIN_PROFILES[a / MAX_FLOWS_PER_PROFILE].flows[a % MAX_FLOWS_PER_PROFILE];
+        for (uint32_t b = a + 1; fa.port != 0 && b < n * MAX_FLOWS_PER_PROFILE; ++b)
+        {
+            if (fa.port == BUILTIN_PROFILES[b / MAX_FLOWS_PER_PROFILE].flows[b % MAX_FLOWS_PER_PROFILE].port)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(BuiltinPortsAreUnique(), "Deux profils intégrés utilisent le même port");
+
+// Table des profils en vigueur : les profils intégrés, suivis de ceux chargés par LoadAppProfiles
+struct ProfileRegistry
+{
+    std::vector<AppProfile> profiles;
+    std::deque<std::string> names;        // chaînes des profils chargés (pointées par key, name, sourceName)
+    std::vector<uint8_t> labelByPort;     // LABEL par port (65 536 entrées), lu pour chaque paquet par l'extraction ML
+    std::vector<int32_t> flowByPort;      // profil * MAX_FLOWS_PER_PROFILE + flux, -1 si aucun
+    uint64_t signature = 0;               // empreinte des fichiers chargés (0 : profils intégrés seuls)
+
+    ProfileRegistry()
+        : profiles(std::begin(BUILTIN_PROFILES), std::end(BUILTIN_PROFILES))
+    {
+        Index();
+    }
+
+    void Index()
+    {
+        labelByPort.assign(65536, 0);
+        flowByPort.assign(65536, -1);
+        for (uint32_t p = 0; p < profiles.size(); ++p)
+        {
+            for (uint32_t f = 0; f < profiles[p].flowCount; ++f)
+            {
+                labelByPort[profiles[p].flows[f].port] = profiles[p].flows[f].label;
+                flowByPort[profiles[p].flows[f].port] = (int32_t)(p * MAX_FLOWS_PER_PROFILE + f);
+            }
+        }
+    }
+};
+
+inline ProfileRegistry &GetProfileRegistry()
+{
+    static ProfileRegistry registry;
+    return registry;
+}
+
+inline const std::vector<AppProfile> &AppProfiles()
+{
+    return GetProfileRegistry().profiles;
+}
+
+inline uint32_t ProfileCount()
+{
+    return (uint32_t)GetProfileRegistry().profiles.size();
+}
+
+// Flux d'un port, nullptr si le port n'appartient à aucun profil
+inline const FlowProfile *FindFlowProfile(uint16_t port)
+{
+    const ProfileRegistry &registry = GetProfileRegistry();
+    int32_t index = registry.flowByPort[port];
+    return index < 0 ? nullptr : &registry.profiles[index / MAX_FLOWS_PER_PROFILE].flows[index % MAX_FLOWS_PER_PROFILE];
+}
+
+inline int ProfileLabel(uint16_t port)
+{
+    return GetProfileRegistry().labelByPort[port];
+}
+
+// Débit "2Mbps", "50kbps", "72000" en bits/s ; false si la valeur n'est pas lisible
+inline bool ParseProfileRate(const std::string &text, uint64_t &bps)
+{
+    char *end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    std::string unit(end);
+    double scale = 1.0;
+    if (!unit.empty() && (unit[0] == 'k' || unit[0] == 'K' || unit[0] == 'M' || unit[0] == 'G'))
+    {
+        scale = unit[0] == 'G' ? 1e9 : (unit[0] == 'M' ? 1e6 : 1e3);
+        unit.erase(0, 1);
+    }
+    if (end == text.c_str() || value < 0 || !(unit.empty() || unit == "bps"))
+    {
+        return false;
+    }
+    bps = (uint64_t)(value * scale + 0.5);
+    return true;
+}
+
+// "a" ou "a:b" ; b = a si absent
+inline bool ParseProfileRange(const std::string &text, double &a, double &b)
+{
+    char *end = nullptr;
+    a = std::strtod(text.c_str(), &end);
+    if (end == text.c_str())
+    {
+        return false;
+    }
+    b = a;
+    if (*end == ':')
+    {
+        const char *second = end + 1;
+        b = std::strtod(second, &end);
+        if (end == second)
+        {
+            return false;
+        }
+    }
+    return *end == '\0' && a <= b;
+}
+
+// Lecture d'un fichier de profils par LoadAppProfiles ; les chaînes internées restent dans registry.names en cas d'erreur
+inline bool ReadAppProfiles(const std::string &filename, std::string &error)
+{
+    std::ifstream in(filename);
+    if (!in.is_open())
+    {
+        error = "impossible d'ouvrir " + filename;
+        return false;
+    }
+    ProfileRegistry &registry = GetProfileRegistry();
+    std::vector<AppProfile> added;
+    std::vector<uint8_t> portUsed(65536, 0);
+    for (const AppProfile &p : registry.profiles)
+    {
+        for (uint32_t f = 0; f < p.flowCount; ++f)
+        {
+            portUsed[p.flows[f].port] = 1;
+        }
+    }
+    // Les éléments d'un deque ne sont pas déplacés par push_back : les pointeurs restent valables
+    auto intern = [&registry](const std::string &s) {
+        registry.names.push_back(s);
+        return registry.names.back().c_str();
+    };
+
+    std::string line;
+    std::string content;
+    uint32_t lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        content += line + "\n";
+        ++lineNumber;
+        std::string where = filename + ":" + std::to_string(lineNumber) + " : ";
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::string kind;
+        if (!(tokens >> kind))
+        {
+            continue;
+        }
+        if (kind != "profile" && kind != "flow")
+        {
+            error = where + "ligne profile ou flow attendue";
+            return false;
+        }
+        if (kind == "flow" && added.empty())
+        {
+            error = where + "flow avant tout profile";
+            return false;
+        }
+        if (kind == "flow" && added.back().flowCount == MAX_FLOWS_PER_PROFILE)
+        {
+            error = where + "plus de " + std::to_string(MAX_FLOWS_PER_PROFILE) + " flux dans le profil";
+            return false;
+        }
+
+        AppProfile profile;
+        FlowProfile flow;
+        std::string protocol;
+        std::string token;
+        bool ok = true;
+        while (ok && tokens >> token)
+        {
+            std::size_t eq = token.find('=');
+            std::string key = token.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : token.substr(eq + 1);
+            char *end = nullptr;
+            unsigned long long number = std::strtoull(value.c_str(), &end, 10);
+            bool isNumber = !value.empty() && *end == '\0';
+            if (kind == "profile" && key == "key" && !value.empty())
+            {
+                profile.key = intern(value);
+            }
+            else if (kind == "profile" && key == "count" && isNumber)
+            {
+                profile.defaultCount = (uint32_t)number;
+            }
+            else if (kind == "profile" && key == "start")
+            {
+                double a = 0.0;
+                double b = 0.0;
+                if (value == "random")
+                {
+                    profile.start = StartMode::RANDOM;
+                }
+                else if (value.rfind("uniform:", 0) == 0 && ParseProfileRange(value.substr(8), a, b))
+                {
+                    profile.start = StartMode::UNIFORM;
+                    profile.startMin = a;
+                    profile.startMax = b;
+                }
+                else if (value.rfind("fixed:", 0) == 0 && ParseProfileRange(value.substr(6), a, b) && a == b)
+                {
+                    profile.start = StartMode::FIXED;
+                    profile.startMin = a;
+                }
+                else
+                {
+                    ok = false;
+                }
+            }
+            else if (kind == "flow" && key == "port" && isNumber && number > 0 && number < 65536)
+            {
+                flow.port = (uint16_t)number;
+            }
+            else if (kind == "flow" && key == "name" && !value.empty())
+            {
+                flow.name = intern(value);
+            }
+            else if (kind == "flow" && key == "source" && !value.empty())
+            {
+                flow.sourceName = intern(value);
+            }
+            else if (kind == "flow" && key == "label" && isNumber && number < 256)
+            {
+                flow.label = (uint8_t)number;
+            }
+            else if (kind == "flow" && key == "model" && (value == "udp" || value == "onoff" || value == "bulk"))
+            {
+                flow.model = value == "udp" ? TrafficModel::UDP_CBR : (value == "onoff" ? TrafficModel::ON_OFF : TrafficModel::BULK);
+            }
+            else if (kind == "flow" && key == "protocol" && (value == "udp" || value == "tcp"))
+            {
+                protocol = value;
+            }
+            else if (kind == "flow" && key == "direction" && (value == "up" || value == "down"))
+            {
+                flow.downlink = value == "down";
+            }
+            else if (kind == "flow" && key == "packetSize" && isNumber && number > 0)
+            {
+                flow.packetSize = (uint32_t)number;
+            }
+            else if (kind == "flow" && key == "interval")
+            {
+                ok = ParseProfileRange(value, flow.intervalMin, flow.intervalMax) && flow.intervalMin > 0;
+            }
+            else if (kind == "flow" && key == "rate")
+            {
+                ok = ParseProfileRate(value, flow.dataRateBps);
+            }
+            else if (kind == "flow" && (key == "on" || key == "off"))
+            {
+                double a = 0.0;
+                double b = 0.0;
+                ok = ParseProfileRange(value, a, b) && a == b && a >= 0;
+                (key == "on" ? flow.onTime : flow.offTime) = a;
+            }
+            else if (kind == "flow" && key == "maxPackets" && isNumber)
+            {
+                flow.maxPackets = (uint32_t)number;
+            }
+            else if (kind == "flow" && key == "maxBytes" && isNumber)
+            {
+                flow.maxBytes = number;
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+        if (!ok)
+        {
+            error = where + "valeur invalide : " + token;
+            return false;
+        }
+
+        if (kind == "profile")
+        {
+            if (*profile.key == '\0')
+            {
+                error = where + "profile sans key";
+                return false;
+            }
+            for (const std::vector<AppProfile> *list : {&registry.profiles, &added})
+            {
+                for (const AppProfile &p : *list)
+                {
+                    if (std::string(p.key) == profile.key)
+                    {
+                        error = where + "profil " + profile.key + " déjà défini";
+                        return false;
+                    }
+                }
+            }
+            added.push_back(profile);
+            continue;
+        }
+
+        // Le modèle impose le protocole : UdpClient n'émet qu'en UDP, BulkSend qu'en TCP
+        flow.tcp = flow.model == TrafficModel::BULK || (flow.model == TrafficModel::ON_OFF && protocol != "udp");
+        if ((flow.model == TrafficModel::UDP_CBR && protocol == "tcp") || (flow.model == TrafficModel::BULK && protocol == "udp"))
+        {
+            error = where + "protocole incompatible avec le modèle de trafic";
+            return false;
+        }
+        if (flow.port == 0 || *flow.name == '\0' || portUsed[flow.port])
+        {
+            error = where + "flux sans port ni name, ou port déjà utilisé";
+            return false;
+        }
+        if (flow.model == TrafficModel::ON_OFF && flow.dataRateBps == 0)
+        {
+            error = where + "flux onoff sans rate";
+            return false;
+        }
+        if (*flow.sourceName == '\0')
+        {
+            flow.sourceName = flow.name;
+        }
+        portUsed[flow.port] = 1;
+        AppProfile &owner = added.back();
+        owner.flows[owner.flowCount++] = flow;
+    }
+    for (const AppProfile &p : added)
+    {
+        if (p.flowCount == 0)
+        {
+            error = filename + " : profil " + p.key + " sans flux";
+            return false;
+        }
+    }
+
+    // Empreinte FNV-1a du contenu, pour distinguer les points de balayage obtenus avec d'autres profils
+    uint64_t hash = registry.signature ? registry.signature : 14695981039346656037ULL;
+    for (unsigned char c : content)
+    {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    registry.signature = hash;
+    registry.profiles.insert(registry.profiles.end(), added.begin(), added.end());
+    registry.Index();
+    return true;
+}
+
+/**
+ * @brief Ajoute aux profils en vigueur ceux d'un fichier de profils (format en tête de ce fichier).
+ * Les clés de profil et les ports doivent être nouveaux ; en cas d'erreur, aucun profil n'est ajouté
+ * et les chaînes déjà internées sont libérées.
+ * @return false si le fichier ne peut être lu ou est invalide, avec la raison dans error.
+ */
+inline bool LoadAppProfiles(const std::string &filename, std::string &error)
+{
+    std::deque<std::string> &names = GetProfileRegistry().names;
+    std::size_t interned = names.size();
+    if (!ReadAppProfiles(filename, error))
+    {
+        // Aucun profil en vigueur ne pointe sur les chaînes ajoutées par cette lecture
+        names.resize(interned);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Écrit les profils au format des fichiers de profils, relu à l'identique par LoadAppProfiles et app_profiles.py.
+ * Les profils intégrés ne peuvent pas être rechargés par --profilesFile (clés et ports déjà définis).
+ */
+inline void WriteAppProfiles(std::ostream &out, const std::vector<AppProfile> &profiles)
+{
+    // 15 chiffres significatifs : 0.05 s'écrit 0.05 et non 0.050000000000000003
+    out << std::setprecision(15);
+    for (const AppProfile &p : profiles)
+    {
+        out << "profile key=" << p.key << " count=" << p.defaultCount << " start=";
+        switch (p.start)
+        {
+        case StartMode::RANDOM:
+            out << "random";
+            break;
+        case StartMode::UNIFORM:
+            out << "uniform:" << p.startMin << ":" << p.startMax;
+            break;
+        case StartMode::FIXED:
+            out << "fixed:" << p.startMin;
+            break;
+        }
+        out << "\n";
+        for (uint32_t f = 0; f < p.flowCount; ++f)
+        {
+            const FlowProfile &flow = p.flows[f];
+            out << "flow port=" << flow.port << " name=" << flow.name << " source=" << flow.sourceName
+                << " label=" << (uint32_t)flow.label << " direction=" << (flow.downlink ? "down" : "up");
+            switch (flow.model)
+            {
+            case TrafficModel::UDP_CBR:
+                out << " model=udp packetSize=" << flow.packetSize << " interval=" << flow.intervalMin;
+                if (flow.intervalMin < flow.intervalMax)
+                {
+                    out << ":" << flow.intervalMax;
+                }
+                out << " maxPackets=" << flow.maxPackets;
+                break;
+            case TrafficModel::ON_OFF:
+                out << " model=onoff protocol=" << (flow.tcp ? "tcp" : "udp") << " packetSize=" << flow.packetSize
+                    << " rate=" << flow.dataRateBps << " on=" << flow.onTime << " off=" << flow.offTime;
+                break;
+            case TrafficModel::BULK:
+                out << " model=bulk maxBytes=" << flow.maxBytes;
+                break;
+            }
+            out << "\n";
+        }
+    }
+}
+
+#endif // SIMULATION_DOMESTIQUE_PROFILES_H
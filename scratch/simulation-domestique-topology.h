@@ -0,0 +1,102 @@
+// *************** CODE SOURCE DE BIKOURI HENRI **********************
+
+//************* Mon site web : henribikouri.github.io *************************
+//*********************Email : henri.bikouri@enspy-uy1.cm ****************************
+
+// Géométrie des logements à plusieurs points d'accès (--aps de simulation-domestique) :
+// les AP sont placés au centre de pièces carrées (côté roomSize) disposées en grille sur chaque étage,
+// chaque station est rattachée à l'AP le plus proche.
+// Ce fichier ne dépend pas de ns-3 ; le câblage (BSS, liens de collecte, adressage) est fait par RunSimulation.
+
+#ifndef SIMULATION_DOMESTIQUE_TOPOLOGY_H
+#define SIMULATION_DOMESTIQUE_TOPOLOGY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+struct LayoutPosition
+{
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+};
+
+struct HomeLayout
+{
+    uint32_t floors = 1;
+    uint32_t columns = 1;              // pièces par rangée
+    uint32_t rows = 1;                 // rangées de pièces par étage
+    double roomSize = 10.0;            // côté d'une pièce (m)
+    double floorHeight = 3.0;          // hauteur d'un étage (m)
+    std::vector<LayoutPosition> aps;   // un AP par pièce, étage par étage
+
+    double Width() const
+    {
+        return columns * roomSize;
+    }
+
+    double Depth() const
+    {
+        return rows * roomSize;
+    }
+
+    // Hauteur d'une station posée au niveau de l'étage floor (1 m du sol)
+    double StationHeight(uint32_t floor) const
+    {
+        return floor * floorHeight + 1.0;
+    }
+};
+
+/**
+ * @brief Répartit numAps points d'accès sur floors étages, en grille presque carrée de pièces par étage.
+ * Les AP sont fixés à 2 m du sol au centre de leur pièce (plus près des stations de leur étage, posées à 1 m,
+ * que de celles de l'étage du dessous) ; le dernier étage peut être incomplet.
+ */
+inline HomeLayout BuildHomeLayout(uint32_t numAps, uint32_t floors, double roomSize, double floorHeight)
+{
+    HomeLayout layout;
+    layout.floors = std::max<uint32_t>(1, std::min(floors, numAps));
+    layout.roomSize = roomSize;
+    layout.floorHeight = floorHeight;
+    uint32_t perFloor = (numAps + layout.floors - 1) / layout.floors;
+    layout.columns = (uint32_t)std::ceil(std::sqrt((double)perFloor));
+    layout.rows = (perFloor + layout.columns - 1) / layout.columns;
+
+    layout.aps.reserve(numAps);
+    for (uint32_t i = 0; i < numAps; ++i)
+    {
+        uint32_t floor = i / perFloor;
+        uint32_t room = i % perFloor;
+        LayoutPosition p;
+        p.x = (room % layout.columns + 0.5) * roomSize;
+        p.y = (room / layout.columns + 0.5) * roomSize;
+        p.z = floor * floorHeight + 2.0;
+        layout.aps.push_back(p);
+    }
+    return layout;
+}
+
+// Indice de l'AP le plus proche d'une position (le premier en cas d'égalité)
+inline uint32_t NearestAp(const HomeLayout &layout, const LayoutPosition &p)
+{
+    uint32_t best = 0;
+    double bestDistance = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < layout.aps.size(); ++i)
+    {
+        double dx = layout.aps[i].x - p.x;
+        double dy = layout.aps[i].y - p.y;
+        double dz = layout.aps[i].z - p.z;
+        double distance = dx * dx + dy * dy + dz * dz;
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+#endif // SIMULATION_DOMESTIQUE_TOPOLOGY_H
@@ -7,6 +7,7 @@
 #include "ns3/applications-module.h"
 #include "ns3/node-list.h"
 #include "ns3/wifi-module.h" 
+#include "ns3/spectrum-module.h"
 #include "ns3/mobility-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/ipv4-address.h"
@@ -18,12 +19,43 @@
 #include "ns3/command-line.h"
 #include "ns3/packet-sink.h"
 #include "ns3/ipv4-global-routing-helper.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include <mpi.h>
+#endif
+#ifdef NS3_MTP
+#include "ns3/mtp-interface.h"
+#endif
+#include "simulation-domestique-metrics.h"
+#include "simulation-domestique-ml.h"
+#include "simulation-domestique-common/simulation-domestique-async-writer.h"
+#include "simulation-domestique-topology.h"
+#include "simulation-domestique-profiles.h"
+#include "simulation-domestique-common/simulation-domestique-scheduler-trace.h"
+#include "simulation-domestique-common/simulation-domestique-dary-heap-scheduler.h"
+#include "simulation-domestique-common/simulation-domestique-ladder-scheduler.h"
+#include <algorithm>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <string>
+#include <chrono>
+#include <cmath>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
 using namespace ns3;
 
@@ -31,12 +63,8 @@ using namespace ns3;
 NS_LOG_COMPONENT_DEFINE ("SimulationDomestique");
 
 // --- Choix de mes Constantes pour ce Scénario ---
-
-// Nbre total d'équipements clients Wi-Fi
-const uint32_t N_EQUIPMENTS = 32; 
-
-// Nbre de types d'équipements/applications
-const uint32_t K_TYPES = 10; 
+// Le nombre d'équipements clients Wi-Fi et leur répartition par type ne sont plus des constantes :
+// ils sont décrits par un HouseholdMix (options --mix, --mixFile et --mixScale, voir plus bas).
 
 // Durée de la simulation (en secondes)
 // Par défaut cette constante vaut 600 secondes. Elle peut être modifiée par la ligne de commande (--duration)
@@ -45,6 +73,18 @@ double DUREE_SIMULATION = 600.0; // 10 minutes par défaut
 // structure globale permet de suivre les récepteurs installés sur un nœud/port spécifique afin de ne pas avoir à le faire.
 static std::map<uint32_t, std::map<uint16_t, Ptr<PacketSink>>> g_installedSinks;
 
+// Fenêtre de mesure des métriques : de la fin du préchauffage (--warmup) à l'arrêt de la simulation,
+// éventuellement avancé par le détecteur de régime stationnaire (--steadyState).
+// Les octets reçus par chaque sink avant la fenêtre sont retranchés (g_sinkRxBaseline).
+static double g_measureStart = 0.0;
+static double g_measureEnd = 600.0;
+static std::map<uint32_t, std::map<uint16_t, uint64_t>> g_sinkRxBaseline;
+
+double MeasuredSeconds()
+{
+    return g_measureEnd - g_measureStart;
+}
+
 // Fonction pour obtenir la première adresse IPv4 non locale d'un nœud.
 Ipv4Address GetFirstIpv4Address(Ptr<Node> node)
 {
@@ -107,783 +147,3075 @@ static std::vector<TrafficSourceInfo> g_trafficSources;
 
 
 // Déclaration du générateur aléatoire pour l'heure de début
-Ptr<UniformRandomVariable> debutAleatoire = CreateObject<UniformRandomVariable> ();
+// Il est créé par InitDebutAleatoire() une fois le RngRun connu : créé à l'initialisation statique,
+// son flux ignorait --RngRun et chaque réplication aurait tiré les mêmes heures de début.
+Ptr<UniformRandomVariable> debutAleatoire;
 
-// --- Fonctions de Configuration des Applications (avec enregistrement des sources) ---
-
-// 1. Caméra (Type 1, Port 9001)
-void ConfigureCamera(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+void InitDebutAleatoire()
 {
-    Ipv4Address remoteIp = GetFirstIpv4Address(serverNode);
-    InetSocketAddress remoteSocket(remoteIp, 9001);
-
-    UdpClientHelper clientHelper(remoteSocket);
-    
-    clientHelper.SetAttribute("MaxPackets", UintegerValue(100000));
-    clientHelper.SetAttribute("Interval", TimeValue(MilliSeconds(50))); 
-    clientHelper.SetAttribute("PacketSize", UintegerValue(1200));
-
-    ApplicationContainer clientApp = clientHelper.Install(clientNode);
-    clientApp.Start(Seconds(startTime));
-    clientApp.Stop(Seconds(DUREE_SIMULATION));
-
-    // Enregistrement de la source
-    g_trafficSources.push_back({"Caméra", clientApp.Get(0)});
-
-    Ipv4Address serverIp = GetFirstIpv4Address(serverNode);
-    InetSocketAddress sinkSocket(serverIp, 9001);
-    InstallSinkIfNeeded(serverNode, sinkSocket, "ns3::UdpSocketFactory");
+    debutAleatoire = CreateObject<UniformRandomVariable> ();
+    debutAleatoire->SetAttribute("Min", DoubleValue(0.0));
+    debutAleatoire->SetAttribute("Max", DoubleValue(5.0)); // Aléa [0, 5] secondes
 }
 
-
-// 2. Capteur de Température (TCP Sporadique, Port 9002)
-void ConfigureSensor(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+// --- Flux aléatoires fixes (--fixedStreams) ---
+// Chaque équipement, repéré par (type d'application, rang dans son type), dispose d'un bloc fixe de
+// STREAMS_PER_EQUIPMENT flux : heure de début, paramètre tiré par l'application, variables internes des
+// applications, placement dans un logement à plusieurs AP, périphérique Wi-Fi et pile IP. Ajouter, retirer ou
+// réordonner des équipements ne change donc pas les tirages des autres (nombres aléatoires communs entre configurations).
+// AP, serveurs et routeur ont leurs blocs dans une plage séparée, au-delà de INFRASTRUCTURE_STREAM_BASE.
+// Les flux attribués automatiquement par ns-3 (non fixés) sont pris dans une autre plage et ne les recouvrent pas.
+enum StreamOffset
 {
-    Ipv4Address remoteIp = GetFirstIpv4Address(serverNode);
-    InetSocketAddress remoteSocket(remoteIp, 9002);
-    OnOffHelper clientHelper("ns3::TcpSocketFactory", remoteSocket);
-
-    clientHelper.SetAttribute("DataRate", DataRateValue(DataRate("50kbps")));
-    clientHelper.SetAttribute("PacketSize", UintegerValue(80));
-
-    clientHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=0.5]")); 
-    clientHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=300.0]"));
+    STREAM_START_TIME = 0,      // heure de début
+    STREAM_PARAMETER = 1,       // paramètre tiré à la configuration (intervalle domotique, début de la sonnette)
+    STREAM_APPLICATIONS = 2,    // 2..13 : AssignStreams des applications sources, 4 flux chacune (MAX_FLOWS_PER_PROFILE)
+    STREAM_PLACEMENT = 14,      // position de la station (x, y, étage) dans un logement à plusieurs AP
+    STREAM_WIFI = 16,           // 16..47 : WifiHelper::AssignStreams
+    STREAM_INTERNET = 48,       // 48..63 : InternetStackHelper::AssignStreams
+    STREAMS_PER_EQUIPMENT = 64
+};
 
-    ApplicationContainer clientApp = clientHelper.Install(clientNode);
-    clientApp.Start(Seconds(startTime));
-    clientApp.Stop(Seconds(DUREE_SIMULATION));
+enum InfrastructureRole
+{
+    INFRA_SCENARIO = 0,   // tirages du scénario non rattachés à un équipement (aucun pour l'instant)
+    INFRA_AP = 1,
+    INFRA_SERVER = 2,
+    INFRA_ROUTER = 3
+};
 
-    // Enregistrement de la source
-    g_trafficSources.push_back({"Capteur", clientApp.Get(0)});
+const int64_t MAX_EQUIPMENTS_PER_TYPE = 1 << 20;
+const int64_t INFRASTRUCTURE_STREAM_BASE = (int64_t)1 << 40;
 
-    Ipv4Address serverIp = GetFirstIpv4Address(serverNode);
-    InetSocketAddress sinkSocket(serverIp, 9002);
-    InstallSinkIfNeeded(serverNode, sinkSocket, "ns3::TcpSocketFactory");
+// Premier flux du bloc (offset 0) ou flux offset de l'équipement index du type type
+int64_t EquipmentStream(uint32_t type, uint32_t index, uint32_t offset = 0)
+{
+    NS_ABORT_MSG_IF(index >= MAX_EQUIPMENTS_PER_TYPE || offset >= STREAMS_PER_EQUIPMENT, "Flux hors bloc : type " << type << ", équipement " << index);
+    return ((int64_t)type * MAX_EQUIPMENTS_PER_TYPE + index) * STREAMS_PER_EQUIPMENT + offset;
 }
 
-
-// 3. Assistant Vocal (TCP Rafale Courte, Port 9003)
-void ConfigureVoiceAssistant(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+// Flux offset de l'élément index (AP, serveur, ...) d'un rôle d'infrastructure
+int64_t InfrastructureStream(InfrastructureRole role, uint32_t index, uint32_t offset = 0)
 {
-    Ipv4Address remoteIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress remoteSocket(remoteIp, 9003);
-    OnOffHelper clientHelper("ns3::TcpSocketFactory", remoteSocket);
+    NS_ABORT_MSG_IF(index >= MAX_EQUIPMENTS_PER_TYPE || offset >= STREAMS_PER_EQUIPMENT, "Flux hors bloc : rôle " << role << ", élément " << index);
+    return INFRASTRUCTURE_STREAM_BASE + ((int64_t)role * MAX_EQUIPMENTS_PER_TYPE + index) * STREAMS_PER_EQUIPMENT + offset;
+}
 
-    clientHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=2.0]")); 
-    clientHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=60.0]"));
-    
-    clientHelper.SetAttribute("DataRate", DataRateValue(DataRate("150kbps"))); 
-    clientHelper.SetAttribute("PacketSize", UintegerValue(500)); 
+// Préfixe ajouté aux fichiers produits par une exécution (vide en mode simple, "runN-" pour une réplication,
+// "rankN-" pour un processus d'une exécution distribuée)
+static std::string g_outputPrefix = "";
 
-    ApplicationContainer clientApp = clientHelper.Install(clientNode);
-    clientApp.Start(Seconds(startTime));
-    clientApp.Stop(Seconds(DUREE_SIMULATION));
-    
-    // Enregistrement de la source
-    g_trafficSources.push_back({"AssistantVocal", clientApp.Get(0)});
+// Exécution distribuée (--mpi) : numéro de ce processus et nombre de processus
+static uint32_t g_systemId = 0;
+static uint32_t g_systemCount = 1;
+// Exécution multithread (--mtp) : les traces partagées entre logements y sont refusées
+static bool g_multithreaded = false;
 
-    Ipv4Address serverIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress sinkSocket(serverIp, 9003);
-    InstallSinkIfNeeded(serverNode, sinkSocket, "ns3::TcpSocketFactory");
+std::string OutputName(const std::string &name)
+{
+    return g_outputPrefix + name;
 }
 
+// --- Installation des applications d'un équipement à partir de son profil (simulation-domestique-profiles.h) ---
 
-// 4. Téléchargement de Fichier (TCP Débit Maximal, Port 9004)
-void ConfigureDownload(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+// "ns3::ConstantRandomVariable[Constant=x]" (17 chiffres : la valeur relue est exactement x)
+std::string ConstantVariable(double value)
 {
-    Ipv4Address clientIp = GetFirstIpv4Address(clientNode); // Utilise le helper
-    InetSocketAddress remoteSocket(clientIp, 9004);
-    BulkSendHelper serverHelper("ns3::TcpSocketFactory", remoteSocket);
-    
-    serverHelper.SetAttribute("MaxBytes", UintegerValue(100000000));
-    
-    ApplicationContainer serverApp = serverHelper.Install(serverNode);
-    serverApp.Start(Seconds(startTime));
-    serverApp.Stop(Seconds(DUREE_SIMULATION));
-
-    // Enregistrement de la source (le serveur dans ce cas)
-    g_trafficSources.push_back({"Téléchargement-Serveur", serverApp.Get(0)});
-
-    Ipv4Address sinkIp = GetFirstIpv4Address(clientNode); // Utilise le helper
-    InetSocketAddress sinkSocket(sinkIp, 9004);
-    InstallSinkIfNeeded(clientNode, sinkSocket, "ns3::TcpSocketFactory");
-}
-
-
-// 5. VoIP (UDP Symétrique, Port 9005 et 9006 pour distinction)
-void ConfigureVoIP(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
-{
-    // Sens 1 : Client -> Serveur (Upload, Port 9005)
-    Ipv4Address serverIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress upSocket(serverIp, 9005);
-    OnOffHelper upHelper("ns3::UdpSocketFactory", upSocket);
-    upHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1.0]")); 
-    upHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.0]")); 
-    upHelper.SetAttribute("PacketSize", UintegerValue(180)); 
-    upHelper.SetAttribute("DataRate", DataRateValue(DataRate("72kbps"))); 
-
-    ApplicationContainer upApp = upHelper.Install(clientNode);
-    upApp.Start(Seconds(startTime));
-    upApp.Stop(Seconds(DUREE_SIMULATION));
-    g_trafficSources.push_back({"VoIP_Montante_Client", upApp.Get(0)});
-
-    // Sens 2 : Serveur -> Client (Download, Port 9006)
-    Ipv4Address clientIp = GetFirstIpv4Address(clientNode); // Utilise le helper
-    InetSocketAddress downSocket(clientIp, 9006);
-    OnOffHelper downHelper("ns3::UdpSocketFactory", downSocket);
-    downHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1.0]")); 
-    downHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
-    downHelper.SetAttribute("PacketSize", UintegerValue(180)); 
-    downHelper.SetAttribute("DataRate", DataRateValue(DataRate("72kbps"))); 
-    
-    ApplicationContainer downApp = downHelper.Install(serverNode);
-    downApp.Start(Seconds(startTime));
-    downApp.Stop(Seconds(DUREE_SIMULATION));
-    g_trafficSources.push_back({"VoIP_Descendante_Server", downApp.Get(0)});
-    
-    // Les Sinks sont installés pour recevoir des deux côtés
-    InetSocketAddress sinkSocket1(serverIp, 9005);
-    InetSocketAddress sinkSocket2(clientIp, 9006);
-    
-    InstallSinkIfNeeded(serverNode, sinkSocket1, "ns3::UdpSocketFactory");
-    InstallSinkIfNeeded(clientNode, sinkSocket2, "ns3::UdpSocketFactory");
+    std::ostringstream oss;
+    oss << "ns3::ConstantRandomVariable[Constant=" << std::setprecision(17) << value << "]";
+    return oss.str();
 }
 
+// Installe la source d'un flux sur sourceNode, vers le port du flux sur sinkNode
+ApplicationContainer InstallFlowSource(const FlowProfile &flow, Ptr<Node> sourceNode, Ptr<Node> sinkNode, double intervalSeconds)
+{
+    InetSocketAddress remoteSocket(GetFirstIpv4Address(sinkNode), flow.port);
+    switch (flow.model)
+    {
+        case TrafficModel::UDP_CBR:
+        {
+            UdpClientHelper helper(remoteSocket);
+            helper.SetAttribute("MaxPackets", UintegerValue(flow.maxPackets));
+            helper.SetAttribute("Interval", TimeValue(Seconds(intervalSeconds)));
+            helper.SetAttribute("PacketSize", UintegerValue(flow.packetSize));
+            return helper.Install(sourceNode);
+        }
+        case TrafficModel::ON_OFF:
+        {
+            OnOffHelper helper(flow.tcp ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory", remoteSocket);
+            helper.SetAttribute("OnTime", StringValue(ConstantVariable(flow.onTime)));
+            helper.SetAttribute("OffTime", StringValue(ConstantVariable(flow.offTime)));
+            helper.SetAttribute("DataRate", DataRateValue(DataRate(flow.dataRateBps)));
+            helper.SetAttribute("PacketSize", UintegerValue(flow.packetSize));
+            return helper.Install(sourceNode);
+        }
+        case TrafficModel::BULK:
+        {
+            BulkSendHelper helper("ns3::TcpSocketFactory", remoteSocket);
+            helper.SetAttribute("MaxBytes", UintegerValue(flow.maxBytes));
+            return helper.Install(sourceNode);
+        }
+    }
+    return ApplicationContainer();
+}
 
-// 6. Domotique (UDP Aléatoire, Petit Paquet, Port 9007)
-void ConfigureDomotics(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+/**
+ * @brief Installe les applications d'un équipement : une source par flux du profil (sur l'équipement pour un flux
+ * montant, sur le serveur du type pour un flux descendant), enregistrée dans g_trafficSources, puis les sinks manquants.
+ * @param startTime heure de début tirée pour l'équipement (debutAleatoire), utilisée par les profils StartMode::RANDOM.
+ * @param stream premier flux du bloc de l'équipement (EquipmentStream), ou -1 si les flux sont attribués automatiquement.
+ */
+void InstallProfile(const AppProfile &profile, Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime, int64_t stream)
 {
-    Ipv4Address remoteIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress remoteSocket(remoteIp, 9007);
-    UdpClientHelper clientHelper(remoteSocket);
-    
-    Ptr<UniformRandomVariable> intervalVar = CreateObject<UniformRandomVariable>();
-    intervalVar->SetAttribute("Min", DoubleValue(10.0));
-    intervalVar->SetAttribute("Max", DoubleValue(30.0));
-    double intervalSeconds = intervalVar->GetValue();
-    clientHelper.SetAttribute("Interval", TimeValue(Seconds(intervalSeconds)));
-    clientHelper.SetAttribute("PacketSize", UintegerValue(64));
-    clientHelper.SetAttribute("MaxPackets", UintegerValue(10000)); 
-
-    ApplicationContainer clientApp = clientHelper.Install(clientNode);
-    clientApp.Start(Seconds(startTime));
-    clientApp.Stop(Seconds(DUREE_SIMULATION));
-    
-    // Enregistrement de la source
-    g_trafficSources.push_back({"Domotique", clientApp.Get(0)});
+    // Tirages propres à l'équipement (heure de début, intervalles), avant toute installation
+    Ptr<UniformRandomVariable> parameter;
+    if (profile.HasParameterDraw())
+    {
+        parameter = CreateObject<UniformRandomVariable>();
+        if (stream >= 0)
+        {
+            parameter->SetStream(stream + STREAM_PARAMETER);
+        }
+    }
+
+    // Les sources de tous les flux, puis les sinks (VoIP : montante, descendante, puis les deux sinks)
+    std::vector<double> intervals;
+    for (uint32_t f = 0; f < profile.flowCount; ++f)
+    {
+        const FlowProfile &flow = profile.flows[f];
+        intervals.push_back(flow.intervalMin < flow.intervalMax ? parameter->GetValue(flow.intervalMin, flow.intervalMax) : flow.intervalMin);
+    }
+    double start = startTime;
+    if (profile.start == StartMode::UNIFORM)
+    {
+        start = parameter->GetValue(profile.startMin, profile.startMax);
+    }
+    else if (profile.start == StartMode::FIXED)
+    {
+        start = profile.startMin;
+    }
 
-    Ipv4Address serverIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress sinkSocket(serverIp, 9007);
-    InstallSinkIfNeeded(serverNode, sinkSocket, "ns3::UdpSocketFactory");
+    for (uint32_t f = 0; f < profile.flowCount; ++f)
+    {
+        const FlowProfile &flow = profile.flows[f];
+        Ptr<Node> sourceNode = flow.downlink ? serverNode : clientNode;
+        Ptr<Node> sinkNode = flow.downlink ? clientNode : serverNode;
+        ApplicationContainer sourceApp = InstallFlowSource(flow, sourceNode, sinkNode, intervals[f]);
+        sourceApp.Start(Seconds(start));
+        sourceApp.Stop(Seconds(DUREE_SIMULATION));
+        g_trafficSources.push_back({flow.sourceName, sourceApp.Get(0)});
+    }
+    for (uint32_t f = 0; f < profile.flowCount; ++f)
+    {
+        const FlowProfile &flow = profile.flows[f];
+        Ptr<Node> sinkNode = flow.downlink ? clientNode : serverNode;
+        InetSocketAddress sinkSocket(GetFirstIpv4Address(sinkNode), flow.port);
+        InstallSinkIfNeeded(sinkNode, sinkSocket, flow.tcp ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
+    }
 }
 
+// --- Description du foyer : nombre d'équipements par type d'application (un profil par type) ---
 
-// 7. Streaming Musical (TCP Rafale Intermittente, Port 9008)
-void ConfigureStreaming(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+// Nombre d'équipements clients Wi-Fi par type (indexé comme AppProfiles())
+struct HouseholdMix
 {
-    Ipv4Address clientIp = GetFirstIpv4Address(clientNode); // Utilise le helper
-    InetSocketAddress remoteSocket(clientIp, 9008);
-    OnOffHelper serverHelper("ns3::TcpSocketFactory", remoteSocket);
+    std::vector<uint32_t> counts;
+
+    // Maison de référence : 5/10/3/2/4/4/1/1/1/1, soit 32 équipements
+    HouseholdMix()
+    {
+        for (const AppProfile &profile : AppProfiles())
+        {
+            counts.push_back(profile.defaultCount);
+        }
+    }
 
-    serverHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=10.0]")); 
-    serverHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=1.0]"));
+    uint32_t Total() const
+    {
+        uint32_t total = 0;
+        for (uint32_t c : counts)
+        {
+            total += c;
+        }
+        return total;
+    }
+};
 
-    serverHelper.SetAttribute("DataRate", DataRateValue(DataRate("2Mbps"))); 
-    serverHelper.SetAttribute("PacketSize", UintegerValue(1400)); 
+// Lit un effectif entier positif ; un jeton mal formé arrête la simulation en citant le contexte (option, clé)
+uint32_t ParseCount(const std::string &token, const std::string &context)
+{
+    char *end = nullptr;
+    errno = 0;
+    unsigned long value = std::strtoul(token.c_str(), &end, 10);
+    NS_ABORT_MSG_IF(token.empty() || token[0] == '-' || end == token.c_str() || *end != '\0' || errno == ERANGE ||
+                        value > std::numeric_limits<uint32_t>::max(),
+                    context << " : effectif invalide '" << token << "'");
+    return (uint32_t)value;
+}
 
-    ApplicationContainer serverApp = serverHelper.Install(serverNode);
-    serverApp.Start(Seconds(startTime));
-    serverApp.Stop(Seconds(DUREE_SIMULATION));
+/**
+ * @brief Applique une description de foyer à un HouseholdMix.
+ * Deux formes sont acceptées (séparateurs : virgule, point-virgule, espace ou retour à la ligne) :
+ * - par clé : "camera=20,sensor=100" (les types non cités gardent leur effectif courant) ;
+ * - positionnelle : "5,10,3,2,4,4,1,1,1,1" (un effectif par profil, dans l'ordre de AppProfiles()).
+ * Tout ce qui suit un '#' sur une ligne est ignoré (commentaires du fichier de scénario).
+ */
+void ParseHouseholdMix(const std::string &spec, HouseholdMix &mix)
+{
+    std::string cleaned;
+    bool inComment = false;
+    for (char c : spec)
+    {
+        if (c == '#') inComment = true;
+        if (c == '\n') inComment = false;
+        if (inComment) continue;
+        cleaned += (c == ',' || c == ';' || c == '\n' || c == '\r' || c == '\t') ? ' ' : c;
+    }
 
-    // Enregistrement de la source
-    g_trafficSources.push_back({"Diffusion-Serveur", serverApp.Get(0)});
+    std::istringstream tokens(cleaned);
+    std::string token;
+    std::vector<uint32_t> positional;
+    while (tokens >> token)
+    {
+        std::size_t sep = token.find_first_of("=:");
+        if (sep == std::string::npos)
+        {
+            positional.push_back(ParseCount(token, "Description du foyer"));
+            continue;
+        }
+        std::string key = token.substr(0, sep);
+        uint32_t count = ParseCount(token.substr(sep + 1), "Description du foyer (" + key + ")");
+        uint32_t i = 0;
+        while (i < ProfileCount() && key != AppProfiles()[i].key) ++i;
+        NS_ABORT_MSG_IF(i == ProfileCount(), "Type d'équipement inconnu dans la description du foyer : " << key);
+        mix.counts[i] = count;
+    }
 
-    Ipv4Address sinkIp = GetFirstIpv4Address(clientNode); // Utilise le helper
-    InetSocketAddress sinkSocket(sinkIp, 9008);
-    InstallSinkIfNeeded(clientNode, sinkSocket, "ns3::TcpSocketFactory");
+    if (!positional.empty())
+    {
+        NS_ABORT_MSG_IF(positional.size() != ProfileCount(), "La description positionnelle du foyer doit contenir " << ProfileCount() << " effectifs");
+        mix.counts = positional;
+    }
 }
 
+// Charge une description de foyer depuis un fichier (même syntaxe que --mix, une entrée par ligne possible)
+void LoadHouseholdMix(const std::string &filename, HouseholdMix &mix)
+{
+    std::ifstream in(filename);
+    NS_ABORT_MSG_IF(!in.is_open(), "Impossible d'ouvrir le fichier de scénario " << filename);
+    std::stringstream content;
+    content << in.rdbuf();
+    ParseHouseholdMix(content.str(), mix);
+}
 
-// 8. Sonnette Connectée (TCP, Très Sporadique, Port 9009)
-void ConfigureDoorbell(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+// Paramètres d'un point de scénario : tout ce qui détermine les résultats, hormis le RngRun
+struct ScenarioConfig
 {
-    Ipv4Address remoteIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress remoteSocket(remoteIp, 9009);
-    OnOffHelper clientHelper("ns3::TcpSocketFactory", remoteSocket);
+    double duration = 600.0;
+    bool forceAc = true;
+    HouseholdMix mix;
+    std::string rateManager = "ns3::MinstrelHtWifiManager";
+    // Logement à plusieurs AP (simulation-domestique-topology.h) : nombre de BSS, étages, taille des pièces (m)
+    uint32_t aps = 1;
+    uint32_t floors = 1;
+    double roomSize = 10.0;
+    double floorHeight = 3.0;
+    // Canal Wi-Fi : modèle (yans ou spectrum) et nombre de canaux 5 GHz sans recouvrement entre lesquels les BSS sont répartis
+    std::string channelModel = "yans";
+    uint32_t wifiChannels = 1;
+    uint16_t wifiChannelWidth = 80;   // MHz
+    // Réceptions écartées sous ce seuil (puissance reçue à la puissance d'émission maximale), canal spectrum seulement ;
+    // NaN : RxSensitivity du PHY récepteur
+    bool rxCulling = false;
+    double cullThresholdDbm = std::numeric_limits<double>::quiet_NaN();
+    // Flux aléatoires fixes par équipement (EquipmentStream) : nombres aléatoires communs entre configurations
+    bool fixedStreams = false;
+    // Logements isolés : un objet canal par BSS (aucun brouillage entre BSS), imposé par --mtp
+    bool isolatedHomes = false;
+    // Mémorisation des pertes et délais par lien : sans effet sur les résultats, donc absente de Canonical()
+    bool propagationCache = false;
+    // Préchauffage (s) : les compteurs sont remis à zéro à cet instant, pour exclure le démarrage des applications (0 à 5 s)
+    double warmup = 0.0;
+    // Arrêt anticipé quand le débit de chaque application a convergé (moyennes par lots)
+    bool steadyState = false;
+    double steadyBatch = 10.0;        // durée d'un lot (s)
+    double steadyTolerance = 0.05;    // demi-largeur relative maximale de l'IC à 95 % du débit moyen
+    uint32_t steadyMinBatches = 10;
+
+    // Représentation canonique, stable d'une version à l'autre, utilisée pour le hachage des points de balayage
+    std::string Canonical() const
+    {
+        std::ostringstream oss;
+        oss << "duration=" << duration << ";forceAc=" << (forceAc ? 1 : 0) << ";mix=";
+        for (uint32_t i = 0; i < mix.counts.size(); ++i)
+        {
+            oss << (i ? "," : "") << mix.counts[i];
+        }
+        oss << ";rateManager=" << rateManager;
+        // Profils chargés par --profilesFile : leur contenu détermine les effectifs de mix
+        if (GetProfileRegistry().signature != 0)
+        {
+            oss << ";profiles=" << std::hex << GetProfileRegistry().signature << std::dec;
+        }
+        // Ajoutés seulement hors valeurs par défaut : les clés des points déjà en cache restent valables
+        if (aps > 1)
+        {
+            oss << ";aps=" << aps << "," << floors << "," << roomSize << "," << floorHeight;
+        }
+        if (channelModel != "yans" || wifiChannels > 1)
+        {
+            oss << ";channel=" << channelModel << "," << wifiChannels << "," << wifiChannelWidth;
+        }
+        if (rxCulling)
+        {
+            oss << ";culling=";
+            if (std::isnan(cullThresholdDbm))
+            {
+                oss << "rxSensitivity";
+            }
+            else
+            {
+                oss << cullThresholdDbm;
+            }
+        }
+        if (isolatedHomes)
+        {
+            oss << ";isolated=1";
+        }
+        if (fixedStreams)
+        {
+            oss << ";fixedStreams=1";
+        }
+        if (warmup > 0)
+        {
+            oss << ";warmup=" << warmup;
+        }
+        if (steadyState)
+        {
+            oss << ";steady=" << steadyBatch << "," << steadyTolerance << "," << steadyMinBatches;
+        }
+        return oss.str();
+    }
+};
 
-    clientHelper.SetAttribute("DataRate", DataRateValue(DataRate("100kbps"))); 
-    clientHelper.SetAttribute("PacketSize", UintegerValue(250)); 
-    
-    clientHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1.0]")); 
-    clientHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=3600.0]")); 
+// Options de sortie d'une exécution (traces et fichiers de métriques)
+struct OutputOptions
+{
+    bool enableFlowMonitor = false;
+    std::string flowOutput = "traces_de_simulation.xml";
+    bool enablePcap = false;
+    std::string pcapInterfaces = "all";   // "all", "ap" ou liste "nœud[:interface]" séparée par des virgules
+    std::string pcapPorts = "";           // ex. "9001-9011" ; vide : tous les ports
+    std::string pcapProtocol = "all";     // all, tcp ou udp
+    uint32_t pcapSnapLen = 0;             // octets conservés par paquet ; 0 : paquet entier
+    bool asyncTraces = false;             // traces écrites par un thread dédié (tampon circulaire)
+    uint32_t asyncBufferMb = 16;          // taille du tampon circulaire
+    bool enableMlFeatures = false;
+    std::string mlOutput = "dataset_ml_features.csv";
+    bool enableCsv = false;
+    std::string csvOutput = "simulation-domestique-metrics.csv";
+    double sampleInterval = 0.0;          // secondes entre deux relevés de la série temporelle ; 0 : désactivée
+    std::string sampleOutput = "timeseries-simulation-domestique.csv";
+    uint64_t sampleMaxRecords = 1 << 20;  // taille maximale de l'anneau des relevés
+    // "xml" : résultats XML + XML de FlowMonitor ; "binary" : un seul fichier en colonnes (simulation-domestique-metrics.h)
+    std::string metricsFormat = "xml";
+    // Trace des opérations de l'ordonnanceur, rejouée par utils/bench-scheduler --replay ; vide : désactivée
+    std::string schedulerTrace = "";
+
+    bool BinaryMetrics() const
+    {
+        return metricsFormat == "binary";
+    }
+};
 
-    Ptr<UniformRandomVariable> doorbellStartTime = CreateObject<UniformRandomVariable> ();
-    doorbellStartTime->SetAttribute("Min", DoubleValue(0.0));
-    doorbellStartTime->SetAttribute("Max", DoubleValue(180.0)); 
-    
-    ApplicationContainer clientApp = clientHelper.Install(clientNode);
-    clientApp.Start(Seconds(doorbellStartTime->GetValue())); 
-    clientApp.Stop(Seconds(DUREE_SIMULATION));
-    
-    // Enregistrement de la source
-    g_trafficSources.push_back({"Sonnette", clientApp.Get(0)});
+// Coût d'une exécution, renseigné par RunSimulation (repris par le balayage de paramètres)
+struct RunStats
+{
+    double setupSeconds = 0.0;
+    double runSeconds = 0.0;
+    uint64_t events = 0;
+};
+static RunStats g_runStats;
 
-    Ipv4Address serverIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress sinkSocket(serverIp, 9009);
-    InstallSinkIfNeeded(serverNode, sinkSocket, "ns3::TcpSocketFactory");
+// Mémoire résidente du processus (Ko), lue dans /proc/self/statm ; 0 si indisponible
+uint64_t GetResidentMemoryKb()
+{
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    if (!(statm >> sizePages >> residentPages))
+    {
+        return 0;
+    }
+    return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
 }
 
-
-// 9. Mise à Jour Firmware (TCP, Événement Lourd, Port 9010)
-void ConfigureFirmwareUpdate(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+// Type d'application d'un sink, d'après le flux du profil auquel appartient son port
+std::string GetAppTypeName(uint16_t port)
 {
-    Ipv4Address clientIp = GetFirstIpv4Address(clientNode); // Utilise le helper
-    InetSocketAddress remoteSocket(clientIp, 9010);
-    BulkSendHelper serverHelper("ns3::TcpSocketFactory", remoteSocket);
-    
-    serverHelper.SetAttribute("MaxBytes", UintegerValue(500000000));
-    
-    double updateStartTime = 300.0; 
-    
-    ApplicationContainer serverApp = serverHelper.Install(serverNode);
-    serverApp.Start(Seconds(updateStartTime)); 
-    serverApp.Stop(Seconds(DUREE_SIMULATION));
+    const FlowProfile *flow = FindFlowProfile(port);
+    return flow ? flow->name : "Inconnu";
+}
 
-    // Enregistrement de la source
-    g_trafficSources.push_back({"MiseAJourFirmware-Serveur", serverApp.Get(0)});
+// Accumulateur des statistiques FlowMonitor d'un récepteur (sink), rempli en une seule passe sur les flux.
+struct SinkMetrics
+{
+    uint32_t nodeId;
+    uint16_t port;
+    Ptr<PacketSink> sink;
+    uint64_t rxBaseline = 0;      // octets reçus par le sink avant la fenêtre de mesure
+    uint64_t txPackets = 0;
+    uint64_t rxPackets = 0;
+    uint64_t lostPackets = 0;
+    uint64_t txBytes = 0;
+    uint64_t rxBytes = 0;
+    Time delaySum = Seconds(0.0);
+    Time jitterSum = Seconds(0.0);
+};
 
-    Ipv4Address sinkIp = GetFirstIpv4Address(clientNode); // Utilise le helper
-    InetSocketAddress sinkSocket(sinkIp, 9010);
-    InstallSinkIfNeeded(clientNode, sinkSocket, "ns3::TcpSocketFactory");
+// Clé de hachage d'une extrémité de flux : adresse IPv4 (32 bits) et port (16 bits)
+inline uint64_t MakeEndpointKey(Ipv4Address addr, uint16_t port)
+{
+    return (static_cast<uint64_t>(addr.Get()) << 16) | port;
 }
 
-
-// 10. Monitoring Réseau (UDP, Régulier Léger, Port 9011)
-void ConfigureMonitoring(Ptr<Node> clientNode, Ptr<Node> serverNode, double startTime)
+// Construit un accumulateur par sink (dans l'ordre de g_installedSinks) et l'index (adresse, port) -> accumulateur.
+void BuildSinkIndex(std::vector<SinkMetrics> &metrics, std::unordered_map<uint64_t, std::size_t> &index)
 {
-    Ipv4Address remoteIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress remoteSocket(remoteIp, 9011);
-    UdpClientHelper clientHelper(remoteSocket);
+    for (const auto& pairNode : g_installedSinks)
+    {
+        uint32_t nodeId = pairNode.first;
+        // L'adresse du nœud n'est résolue qu'une fois par nœud, et non plus pour chaque couple (sink, flux)
+        Ipv4Address nodeIp = GetFirstIpv4Address(NodeList::GetNode(nodeId));
+        for (const auto& pairPort : pairNode.second)
+        {
+            SinkMetrics m;
+            m.nodeId = nodeId;
+            m.port = pairPort.first;
+            m.sink = pairPort.second;
+            auto baselineNode = g_sinkRxBaseline.find(nodeId);
+            if (baselineNode != g_sinkRxBaseline.end() && baselineNode->second.count(m.port))
+            {
+                m.rxBaseline = baselineNode->second.at(m.port);
+            }
+            index[MakeEndpointKey(nodeIp, m.port)] = metrics.size();
+            metrics.push_back(m);
+        }
+    }
+}
 
-    clientHelper.SetAttribute("Interval", TimeValue(Seconds(2.0))); 
-    clientHelper.SetAttribute("PacketSize", UintegerValue(300)); 
-    clientHelper.SetAttribute("MaxPackets", UintegerValue(10000));
+// Ajoute les statistiques d'un flux à l'accumulateur d'un sink
+inline void AccumulateFlow(SinkMetrics &m, const FlowMonitor::FlowStats &fs)
+{
+    m.txPackets += fs.txPackets;
+    m.rxPackets += fs.rxPackets;
+    m.lostPackets += fs.lostPackets;
+    m.txBytes += fs.txBytes;
+    m.rxBytes += fs.rxBytes;
+    m.delaySum += fs.delaySum;
+    m.jitterSum += fs.jitterSum;
+}
 
-    ApplicationContainer clientApp = clientHelper.Install(clientNode);
-    clientApp.Start(Seconds(startTime));
-    clientApp.Stop(Seconds(DUREE_SIMULATION));
+// Sinks d'un flux : celui de sa destination et/ou celui de sa source (-1 si absent ; la source n'est
+// retenue que si elle diffère de la destination, un flux n'est donc jamais compté deux fois pour un sink)
+inline void ResolveFlowSinks(const std::unordered_map<uint64_t, std::size_t> &index, const Ipv4FlowClassifier::FiveTuple &t,
+                             int32_t &dstSink, int32_t &srcSink)
+{
+    auto dst = index.find(MakeEndpointKey(t.destinationAddress, t.destinationPort));
+    auto src = index.find(MakeEndpointKey(t.sourceAddress, t.sourcePort));
+    dstSink = dst != index.end() ? (int32_t)dst->second : -1;
+    srcSink = (src != index.end() && (int32_t)src->second != dstSink) ? (int32_t)src->second : -1;
+}
 
-    // Enregistrement de la source
-    g_trafficSources.push_back({"Supervision", clientApp.Get(0)});
+inline void AccumulateFlowToSinks(std::vector<SinkMetrics> &metrics, int32_t dstSink, int32_t srcSink, const FlowMonitor::FlowStats &fs)
+{
+    if (dstSink >= 0)
+    {
+        AccumulateFlow(metrics[dstSink], fs);
+    }
+    if (srcSink >= 0)
+    {
+        AccumulateFlow(metrics[srcSink], fs);
+    }
+}
 
-    Ipv4Address serverIp = GetFirstIpv4Address(serverNode); // Utilise le helper
-    InetSocketAddress sinkSocket(serverIp, 9011);
-    InstallSinkIfNeeded(serverNode, sinkSocket, "ns3::UdpSocketFactory");
+// Taux de perte (%). Après FlowMonitor::ResetAllStats (fin du préchauffage), des paquets émis avant la remise à zéro
+// sont encore reçus : rxPackets peut dépasser txPackets, la différence signée est alors ramenée à 0
+inline double LossPercent(uint64_t txPackets, uint64_t rxPackets)
+{
+    if (txPackets == 0)
+    {
+        return 0.0;
+    }
+    int64_t lost = std::max<int64_t>(0, (int64_t)txPackets - (int64_t)rxPackets);
+    return (double)lost * 100.0 / (double)txPackets;
 }
 
 /**
  * @brief Calcule et affiche les métriques de performance pour chaque application.
- * * Cette fonction itère sur tous les sinks installés (récepteurs) et calcule :
- * 1. Le débit : Octets reçus * 8 / (Durée de simulation * 10^6) -> Mbits/s
- * 2. Le taux de perte de paquets (Loss Rate) : Non calculé actuellement (N/A)
+ * * Les statistiques FlowMonitor sont parcourues une seule fois : chaque flux est classé une fois,
+ * puis rattaché au(x) sink(s) correspondant(s) par une table de hachage indexée sur (adresse, port).
+ * La console, le XML, le CSV par flux et le résumé CSV sont ensuite produits à partir de ces accumulateurs :
+ * 1. Le débit : Octets reçus * 8 / (Durée de la fenêtre de mesure * 10^6) -> Mbits/s
+ * 2. Le taux de perte, le délai et la gigue moyens (si FlowMonitor est actif)
  */
-void CalculateMetrics(Ptr<FlowMonitor> monitor = 0, Ptr<Ipv4FlowClassifier> classifier = 0, bool enableCsv = false, const std::string &csvOutput = "simulation-domestique-metrics.csv")
+void CalculateMetrics(Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier, const OutputOptions &outputs)
 {
-    // Ouvrir un fichier pour sauvegarder les résultats (XML)
-    std::ofstream resultsFile;
-    // Changement du format de sortie vers XML
-    resultsFile.open("simulation-domestique-metrics.xml");
-    
-    // Écrire le préambule XML et la balise racine
-    resultsFile << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl;
-    resultsFile << "<SimulationMetrics duration_seconds=\"" << DUREE_SIMULATION << "\">" << std::endl;
-    
-    
+    std::vector<SinkMetrics> metrics;
+    std::unordered_map<uint64_t, std::size_t> sinkIndex;
+    BuildSinkIndex(metrics, sinkIndex);
+
+    const std::string &csvOutput = outputs.csvOutput;
+    bool haveFlows = monitor && classifier;
+    bool writeCsv = outputs.enableCsv && haveFlows;
+    bool binary = outputs.BinaryMetrics();
+    MetricsFlowColumns flowColumns;
+
+    // CSV détaillé par flux, rempli pendant la même passe que l'agrégation
+    std::ofstream csvFile;
+    if (writeCsv)
+    {
+        csvFile.open(OutputName(csvOutput));
+        csvFile << "flowId,srcAddr,srcPort,dstAddr,dstPort,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs" << "\n";
+    }
 
-    // Étape 2 : Collecter les métriques de réception pour tous les sinks
-    for (const auto& pairNode : g_installedSinks)
+    // Étape 1 : une seule passe sur les flux FlowMonitor (sans copie de la table)
+    if (haveFlows)
     {
-        uint32_t nodeId = pairNode.first;
-        for (const auto& pairPort : pairNode.second)
+        const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats();
+        for (const auto &kv : stats)
         {
-            uint16_t port = pairPort.first;
-            Ptr<PacketSink> sink = pairPort.second;
-            
-            if (!sink) continue;
-
-            // Données de réception du sink
-            uint64_t totalReceivedBytes = sink->GetTotalRx();
-            
-            // Débit (Octets/s -> Mbits/s)
-            // Débit = (Octets reçus * 8) / (Durée de simulation * 10^6)
-            double throughputMbps = (totalReceivedBytes * 8.0) / (DUREE_SIMULATION * 1000000.0);
-            
-            // Trouve le type d'application basé sur le port (approximatif)
-            std::string appType = "Inconnu";
-            switch (port)
-            {
-                case 9001: appType = "Caméra"; break;
-                case 9002: appType = "Capteur"; break;
-                case 9003: appType = "AssistantVocal"; break;
-                case 9004: appType = "Téléchargement"; break;
-                case 9005: appType = "VoIP_LiaisonMontante"; break;
-                case 9006: appType = "VoIP_LiaisonDescendante"; break;
-                case 9007: appType = "Domotique"; break;
-                case 9008: appType = "Diffusion"; break;
-                case 9009: appType = "Sonnette"; break;
-                case 9010: appType = "MiseAJourFirmware"; break;
-                case 9011: appType = "Supervision"; break;
-            }
-            
-            // Recueil les  métriques additionnelles si FlowMonitor/Classifier disponibles
-            double lossPct = 0.0;
-            double meanDelayMs = 0.0;
-            double meanJitterMs = 0.0;
-            uint64_t txPacketsAgg = 0, rxPacketsAgg = 0, lostPacketsAgg = 0;
-            uint64_t txBytesAgg = 0, rxBytesAgg = 0;
-            if (monitor && classifier)
-            {
-                // Aggrége les statistiques de flow correspondant à ce sink (destination = node IP & port)
-                Ptr<Node> n = NodeList::GetNode(nodeId);
-                Ipv4Address nodeIp = GetFirstIpv4Address(n);
-                std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
-                for (auto &kv2 : stats)
-                {
-                    FlowId fId = kv2.first;
-                    FlowMonitor::FlowStats fs = kv2.second;
-                    Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(fId);
-                    if ((t.destinationAddress == nodeIp && t.destinationPort == port) || (t.sourceAddress == nodeIp && t.sourcePort == port))
-                    {
-                        txPacketsAgg += fs.txPackets;
-                        rxPacketsAgg += fs.rxPackets;
-                        lostPacketsAgg += fs.lostPackets;
-                        txBytesAgg += fs.txBytes;
-                        rxBytesAgg += fs.rxBytes;
-                    }
-                }
-                // Calculer perte et moyenne de délai/jitter si possible
-                if (txPacketsAgg > 0)
+            FlowId flowId = kv.first;
+            const FlowMonitor::FlowStats &fs = kv.second;
+            Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flowId);
+
+            // Un flux est rattaché au sink de sa destination et/ou à celui de sa source (même règle qu'auparavant)
+            int32_t dstSink, srcSink;
+            ResolveFlowSinks(sinkIndex, t, dstSink, srcSink);
+            AccumulateFlowToSinks(metrics, dstSink, srcSink, fs);
+
+            if (binary)
+            {
+                flowColumns.flowId.push_back(flowId);
+                flowColumns.srcAddr.push_back(t.sourceAddress.Get());
+                flowColumns.dstAddr.push_back(t.destinationAddress.Get());
+                flowColumns.srcPort.push_back(t.sourcePort);
+                flowColumns.dstPort.push_back(t.destinationPort);
+                flowColumns.protocol.push_back(t.protocol);
+                flowColumns.txPackets.push_back(fs.txPackets);
+                flowColumns.rxPackets.push_back(fs.rxPackets);
+                flowColumns.lostPackets.push_back(fs.lostPackets);
+                flowColumns.txBytes.push_back(fs.txBytes);
+                flowColumns.rxBytes.push_back(fs.rxBytes);
+                flowColumns.delaySumNs.push_back(fs.delaySum.GetNanoSeconds());
+                flowColumns.jitterSumNs.push_back(fs.jitterSum.GetNanoSeconds());
+                flowColumns.timeFirstTxNs.push_back(fs.timeFirstTxPacket.GetNanoSeconds());
+                flowColumns.timeLastTxNs.push_back(fs.timeLastTxPacket.GetNanoSeconds());
+                flowColumns.timeFirstRxNs.push_back(fs.timeFirstRxPacket.GetNanoSeconds());
+                flowColumns.timeLastRxNs.push_back(fs.timeLastRxPacket.GetNanoSeconds());
+            }
+
+            if (writeCsv)
+            {
+                double lossPct = LossPercent(fs.txPackets, fs.rxPackets);
+                double durationSeconds = (fs.timeLastTxPacket.GetSeconds() - fs.timeFirstTxPacket.GetSeconds());
+                double throughputMbps = 0.0;
+                if (durationSeconds > 0.0)
                 {
-                    lossPct = (double)(txPacketsAgg - rxPacketsAgg) * 100.0 / (double)txPacketsAgg;
+                    throughputMbps = (fs.rxBytes * 8.0) / (durationSeconds * 1000000.0);
                 }
-                if (rxPacketsAgg > 0)
+                double meanDelayMs = 0.0;
+                double meanJitterMs = 0.0;
+                if (fs.rxPackets > 0)
                 {
-                    // Pour delay/jitter, nous allons calculer via toutes les flows correspondantes
-                    Time delaySum = Seconds(0.0);
-                    Time jitterSum = Seconds(0.0);
-                    for (auto &kv2 : stats)
-                    {
-                        FlowMonitor::FlowStats fs = kv2.second;
-                        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(kv2.first);
-                        if ((t.destinationAddress == nodeIp && t.destinationPort == port) || (t.sourceAddress == nodeIp && t.sourcePort == port))
-                        {
-                            delaySum += fs.delaySum;
-                            jitterSum += fs.jitterSum;
-                        }
-                    }
-                    meanDelayMs = (delaySum.GetSeconds() / (double)rxPacketsAgg) * 1000.0;
-                    meanJitterMs = (jitterSum.GetSeconds() / (double)rxPacketsAgg) * 1000.0;
+                    meanDelayMs = (fs.delaySum.GetSeconds() / (double)fs.rxPackets) * 1000.0;
+                    meanJitterMs = (fs.jitterSum.GetSeconds() / (double)fs.rxPackets) * 1000.0;
                 }
+                csvFile << flowId << "," << t.sourceAddress << "," << t.sourcePort << "," << t.destinationAddress << "," << t.destinationPort << ","
+                        << fs.txPackets << "," << fs.rxPackets << "," << fs.lostPackets << "," << lossPct << "," << fs.txBytes << "," << fs.rxBytes << "," << std::fixed << std::setprecision(6) << throughputMbps << "," << meanDelayMs << "," << meanJitterMs << "\n";
             }
+        }
+    }
+    if (writeCsv)
+    {
+        csvFile.close();
+        NS_LOG_INFO("CSV des métriques FlowMonitor sauvegardées dans " << OutputName(csvOutput));
+    }
+
+    // Étape 2 : émission console + XML (ou table binaire des sinks) à partir des accumulateurs.
+    // Les lignes XML se terminent par '\n' : std::endl vidait le flux à chaque <Result>.
+    std::ofstream resultsFile;
+    MetricsSinkColumns sinkColumns;
+    if (!binary)
+    {
+        resultsFile.open(OutputName("simulation-domestique-metrics.xml"));
+        resultsFile << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << "\n";
+        resultsFile << "<SimulationMetrics duration_seconds=\"" << MeasuredSeconds() << "\" warmup_seconds=\"" << g_measureStart << "\">" << "\n";
+    }
+
+    for (const SinkMetrics &m : metrics)
+    {
+        if (!m.sink) continue;
+
+        // Débit = (Octets reçus * 8) / (Durée de la fenêtre de mesure * 10^6)
+        uint64_t totalReceivedBytes = m.sink->GetTotalRx() - m.rxBaseline;
+        double throughputMbps = (totalReceivedBytes * 8.0) / (MeasuredSeconds() * 1000000.0);
+        std::string appType = GetAppTypeName(m.port);
 
-            // Affichage dans la console
-            std::cout << appType << " (Nœud " << nodeId << ", Port " << port << ") | Reçu: " 
-                      << totalReceivedBytes << " Octets | Débit: " 
-                      << std::fixed << std::setprecision(3) << throughputMbps << " Mbps";
-            if (monitor && classifier) {
-                std::cout << " | Perte: " << std::fixed << std::setprecision(3) << lossPct << "% | Délai moyen: " << meanDelayMs << " ms | Jitter moyen: " << meanJitterMs << " ms";
+        double lossPct = 0.0;
+        double meanDelayMs = 0.0;
+        double meanJitterMs = 0.0;
+        if (haveFlows)
+        {
+            lossPct = LossPercent(m.txPackets, m.rxPackets);
+            if (m.rxPackets > 0)
+            {
+                meanDelayMs = (m.delaySum.GetSeconds() / (double)m.rxPackets) * 1000.0;
+                meanJitterMs = (m.jitterSum.GetSeconds() / (double)m.rxPackets) * 1000.0;
             }
-            std::cout << std::endl;
+        }
+
+        // Affichage dans la console
+        std::cout << appType << " (Nœud " << m.nodeId << ", Port " << m.port << ") | Reçu: " 
+                  << totalReceivedBytes << " Octets | Débit: " 
+                  << std::fixed << std::setprecision(3) << throughputMbps << " Mbps";
+        if (haveFlows) {
+            std::cout << " | Perte: " << std::fixed << std::setprecision(3) << lossPct << "% | Délai moyen: " << meanDelayMs << " ms | Jitter moyen: " << meanJitterMs << " ms";
+        }
+        std::cout << std::endl;
 
-            // Sauvegarde dans le fichier au format XML
-            resultsFile << "  <Result type=\"" << appType 
-                        << "\" nodeId=\"" << nodeId 
-                        << "\" port=\"" << port 
-                        << "\" octetsRecus=\"" << totalReceivedBytes 
-                        << "\" debitMbps=\"" << std::fixed << std::setprecision(3) << throughputMbps 
-                        << "\" tauxPertePct=\"" << std::fixed << std::setprecision(3) << lossPct 
-                        << "\" moyenneDelaiMs=\"" << std::fixed << std::setprecision(3) << meanDelayMs 
-                        << "\" moyenneJitterMs=\"" << std::fixed << std::setprecision(3) << meanJitterMs 
-                        << "\" />" << std::endl;
+        if (binary)
+        {
+            sinkColumns.nodeId.push_back(m.nodeId);
+            sinkColumns.port.push_back(m.port);
+            sinkColumns.sinkRxBytes.push_back(totalReceivedBytes);
+            sinkColumns.txPackets.push_back(m.txPackets);
+            sinkColumns.rxPackets.push_back(m.rxPackets);
+            sinkColumns.lostPackets.push_back(m.lostPackets);
+            sinkColumns.txBytes.push_back(m.txBytes);
+            sinkColumns.rxBytes.push_back(m.rxBytes);
+            sinkColumns.delaySumNs.push_back(m.delaySum.GetNanoSeconds());
+            sinkColumns.jitterSumNs.push_back(m.jitterSum.GetNanoSeconds());
+            continue;
         }
+
+        // Sauvegarde dans le fichier au format XML
+        resultsFile << "  <Result type=\"" << appType 
+                    << "\" nodeId=\"" << m.nodeId 
+                    << "\" port=\"" << m.port 
+                    << "\" octetsRecus=\"" << totalReceivedBytes 
+                    << "\" debitMbps=\"" << std::fixed << std::setprecision(3) << throughputMbps 
+                    << "\" tauxPertePct=\"" << std::fixed << std::setprecision(3) << lossPct 
+                    << "\" moyenneDelaiMs=\"" << std::fixed << std::setprecision(3) << meanDelayMs 
+                    << "\" moyenneJitterMs=\"" << std::fixed << std::setprecision(3) << meanJitterMs 
+                    << "\" />" << "\n";
     }
-    
-    resultsFile << "</SimulationMetrics>" << std::endl;
-    resultsFile.close();
-    // Si demandé, ouvrir et écrire un CSV avec des métriques détaillées de flux via FlowMonitor
-    if (enableCsv && monitor && classifier)
-    {
-        // Préparer le classifier et récupérer les statistiques
-        // 'classifier' doit provenir de FlowMonitorHelper créé par RunSimulation
-        std::ofstream csvFile;
-        csvFile.open(csvOutput);
-        csvFile << "flowId,srcAddr,srcPort,dstAddr,dstPort,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs" << std::endl;
-        std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
-        for (auto &kv : stats)
+
+    std::string metricsName;
+    if (binary)
+    {
+        metricsName = OutputName("simulation-domestique-metrics.bin");
+        if (!WriteBinaryMetrics(metricsName, MeasuredSeconds(), sinkColumns, flowColumns))
         {
-            FlowId flowId = kv.first;
-            FlowMonitor::FlowStats fs = kv.second;
-            Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flowId);
-            double lossPct = 0.0;
-            if (fs.txPackets > 0)
-            {
-                lossPct = (double)(fs.txPackets - fs.rxPackets) * 100.0 / (double)fs.txPackets;
-            }
-            double durationSeconds = (fs.timeLastTxPacket.GetSeconds() - fs.timeFirstTxPacket.GetSeconds());
-            double throughputMbps = 0.0;
-            if (durationSeconds > 0.0)
-            {
-                throughputMbps = (fs.rxBytes * 8.0) / (durationSeconds * 1000000.0);
-            }
-            double meanDelayMs = 0.0;
-            if (fs.rxPackets > 0)
-            {
-                meanDelayMs = (fs.delaySum.GetSeconds() / (double)fs.rxPackets) * 1000.0;
-            }
-            double meanJitterMs = 0.0;
-            if (fs.rxPackets > 0)
-            {
-                meanJitterMs = (fs.jitterSum.GetSeconds() / (double)fs.rxPackets) * 1000.0;
-            }
-            csvFile << flowId << "," << t.sourceAddress << "," << t.sourcePort << "," << t.destinationAddress << "," << t.destinationPort << ","
-                    << fs.txPackets << "," << fs.rxPackets << "," << fs.lostPackets << "," << lossPct << "," << fs.txBytes << "," << fs.rxBytes << "," << std::fixed << std::setprecision(6) << throughputMbps << "," << meanDelayMs << "," << meanJitterMs << std::endl;
+            NS_LOG_WARN("Échec de l'écriture des métriques binaires dans " << metricsName);
         }
-        csvFile.close();
-        NS_LOG_INFO("CSV des métriques FlowMonitor sauvegardées dans " << csvOutput);
-        // Ajouter un résumé par application (sink) si demandé
+    }
+    else
+    {
+        metricsName = OutputName("simulation-domestique-metrics.xml");
+        resultsFile << "</SimulationMetrics>" << "\n";
+        resultsFile.close();
+    }
+
+    // Étape 3 : résumé CSV par application (sink), à partir des mêmes accumulateurs
+    if (writeCsv)
+    {
         std::ofstream csvSummary;
-        std::string summaryName = std::string("summary-") + csvOutput;
+        std::string summaryName = std::string("summary-") + OutputName(csvOutput);
         csvSummary.open(summaryName);
-        csvSummary << "nodeId,port,appType,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs" << std::endl;
-        std::map<FlowId, FlowMonitor::FlowStats> stats2 = monitor->GetFlowStats();
-        for (const auto& pairNode : g_installedSinks)
-        {
-            uint32_t nodeId = pairNode.first;
-            Ptr<Node> n = NodeList::GetNode(nodeId);
-            Ipv4Address nodeIp = GetFirstIpv4Address(n);
-            for (const auto& pairPort : pairNode.second)
-            {
-                uint16_t port = pairPort.first;
-                uint64_t txPacketsAgg = 0, rxPacketsAgg = 0, lostPacketsAgg = 0;
-                uint64_t txBytesAgg = 0, rxBytesAgg = 0;
-                Time delaySum = Seconds(0.0);
-                Time jitterSum = Seconds(0.0);
-                for (auto &kv2 : stats2)
-                {
-                    FlowMonitor::FlowStats fs = kv2.second;
-                    Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(kv2.first);
-                    if ((t.destinationAddress == nodeIp && t.destinationPort == port) || (t.sourceAddress == nodeIp && t.sourcePort == port))
-                    {
-                        txPacketsAgg += fs.txPackets;
-                        rxPacketsAgg += fs.rxPackets;
-                        lostPacketsAgg += fs.lostPackets;
-                        txBytesAgg += fs.txBytes;
-                        rxBytesAgg += fs.rxBytes;
-                        delaySum += fs.delaySum;
-                        jitterSum += fs.jitterSum;
-                    }
-                }
-                double lossPct = 0.0;
-                if (txPacketsAgg > 0) lossPct = (double)(txPacketsAgg - rxPacketsAgg) * 100.0 / (double)txPacketsAgg;
-                double meanDelayMs = 0.0, meanJitterMs = 0.0, throughputMbps = 0.0;
-                if (rxPacketsAgg > 0) {
-                    meanDelayMs = (delaySum.GetSeconds() / (double)rxPacketsAgg) * 1000.0;
-                    meanJitterMs = (jitterSum.GetSeconds() / (double)rxPacketsAgg) * 1000.0;
-                }
-                if (DUREE_SIMULATION > 0)
-                {
-                    throughputMbps = (rxBytesAgg * 8.0) / (DUREE_SIMULATION * 1000000.0);
-                }
-                // Déduire le type d'application (même mapping que plus haut)
-                std::string appType = "Inconnu";
-                switch (port)
-                {
-                    case 9001: appType = "Caméra"; break;
-                    case 9002: appType = "Capteur"; break;
-                    case 9003: appType = "AssistantVocal"; break;
-                    case 9004: appType = "Téléchargement"; break;
-                    case 9005: appType = "VoIP_LiaisonMontante"; break;
-                    case 9006: appType = "VoIP_LiaisonDescendante"; break;
-                    case 9007: appType = "Domotique"; break;
-                    case 9008: appType = "Diffusion"; break;
-                    case 9009: appType = "Sonnette"; break;
-                    case 9010: appType = "MiseAJourFirmware"; break;
-                    case 9011: appType = "Supervision"; break;
-                }
-                csvSummary << nodeId << "," << port << "," << appType << "," << txPacketsAgg << "," << rxPacketsAgg << "," << lostPacketsAgg << "," << lossPct << "," << txBytesAgg << "," << rxBytesAgg << "," << throughputMbps << "," << meanDelayMs << "," << meanJitterMs << std::endl;
+        csvSummary << "nodeId,port,appType,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs" << "\n";
+        for (const SinkMetrics &m : metrics)
+        {
+            double lossPct = LossPercent(m.txPackets, m.rxPackets);
+            double meanDelayMs = 0.0, meanJitterMs = 0.0, throughputMbps = 0.0;
+            if (m.rxPackets > 0) {
+                meanDelayMs = (m.delaySum.GetSeconds() / (double)m.rxPackets) * 1000.0;
+                meanJitterMs = (m.jitterSum.GetSeconds() / (double)m.rxPackets) * 1000.0;
+            }
+            if (MeasuredSeconds() > 0)
+            {
+                throughputMbps = (m.rxBytes * 8.0) / (MeasuredSeconds() * 1000000.0);
             }
+            csvSummary << m.nodeId << "," << m.port << "," << GetAppTypeName(m.port) << "," << m.txPackets << "," << m.rxPackets << "," << m.lostPackets << "," << lossPct << "," << m.txBytes << "," << m.rxBytes << "," << throughputMbps << "," << meanDelayMs << "," << meanJitterMs << "\n";
         }
         csvSummary.close();
         NS_LOG_INFO("Résumé CSV par application sauvegardé dans " << summaryName);
     }
-    NS_LOG_INFO("Métriques sauvegardées dans simulation-domestique-metrics.xml");
+    NS_LOG_INFO("Métriques sauvegardées dans " << metricsName);
 }
 
 
-void RunSimulation(bool forceAc, bool enableFlowMonitor, const std::string &flowOutput, bool enablePcap, bool enableCsv, const std::string &csvOutput)
+// Moyenne et variance en ligne (algorithme de Welford, comme dans utils/bench-scheduler.cc)
+struct RunningStat
 {
-    // --- 1. Création des Nœuds ---
-    NodeContainer clientNodes;
-    clientNodes.Create (N_EQUIPMENTS); 
+    uint32_t n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
 
-    NodeContainer serverNodes;
-    serverNodes.Create (K_TYPES); 
+    void Add(double x)
+    {
+        ++n;
+        double deltaPre = x - mean;
+        mean += deltaPre / n;
+        m2 += deltaPre * (x - mean);
+    }
 
-    Ptr<Node> apNode = CreateObject<Node> (); 
+    // Écart-type de l'échantillon (n - 1)
+    double Stdev() const
+    {
+        return n > 1 ? std::sqrt(m2 / (n - 1)) : 0.0;
+    }
 
-    // --- 2. Configuration du Canal Wi-Fi & Mobilité ---
-    YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default();
-    Ptr<YansWifiChannel> channel = channelHelper.Create();
-    
-    // Piste d'amélioration : modèle de propagation plus réaliste pour le domaine
-    // channelHelper.AddPropagationLoss("ns3::LogDistancePropagationLossModel", 
-    //                                  "Exponent", DoubleValue(3.0)); // Ajout de murs/distance
-    
-    YansWifiPhyHelper phyHelper;
-    phyHelper.SetChannel(channel);
-   
-    // Piste d'amélioration : configuration de la sensibilité du récepteur (si vous étudiez la portée)
-    // phyHelper.Set("EnergyDetectionThreshold", DoubleValue(-96.0));
-    
-    MobilityHelper mobility;
-    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-    mobility.Install(apNode);
-    mobility.Install(clientNodes);
-    mobility.Install(serverNodes); 
-    
+    // Demi-largeur de l'intervalle de confiance à 95 % (loi de Student, n - 1 degrés de liberté)
+    double HalfWidth() const
+    {
+        static const double t975[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                      2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                      2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (n < 2)
+        {
+            return 0.0;
+        }
+        uint32_t df = n - 1;
+        double t = df <= 30 ? t975[df - 1] : (df <= 60 ? 2.000 : (df <= 120 ? 1.980 : 1.960));
+        return t * Stdev() / std::sqrt((double)n);
+    }
+};
+
+// --- Séries temporelles par application (--sampleInterval) ---
+// Toutes les sampleInterval secondes, le débit reçu par chaque sink (GetTotalRx) et les compteurs FlowMonitor
+// de ses flux sont relevés ; seules les variations sur l'intervalle sont gardées, dans un anneau d'enregistrements
+// de taille fixe alloué au démarrage (les plus anciens sont écrasés s'il déborde). Les sinks de chaque flux sont
+// mis en cache dans une table indexée par FlowId (attribués dans l'ordre à partir de 1), préallouée puis doublée
+// quand un nouveau flux la dépasse : chaque flux n'est classé qu'une fois.
+
+// Variations d'un sink sur un intervalle
+struct TimeSeriesRecord
+{
+    double time;
+    uint32_t sink;             // indice dans TimeSeriesSampler::current
+    uint64_t sinkRxBytes;
+    uint64_t txPackets;
+    uint64_t rxPackets;
+    uint64_t lostPackets;
+    uint64_t rxBytes;
+    int64_t delaySumNs;
+    int64_t jitterSumNs;
+};
+
+struct TimeSeriesSampler
+{
+    Time interval;
+    Ptr<FlowMonitor> monitor;
+    Ptr<Ipv4FlowClassifier> classifier;
+    std::vector<SinkMetrics> current;                      // cumuls au relevé courant
+    std::vector<SinkMetrics> previous;                     // cumuls au relevé précédent
+    std::vector<uint64_t> previousSinkRx;
+    std::unordered_map<uint64_t, std::size_t> sinkIndex;
+    std::vector<std::pair<int32_t, int32_t>> flowSinks;    // FlowId -> (sink destination, sink source) ; -2 : inconnu
+    std::vector<TimeSeriesRecord> ring;
+    uint64_t recorded = 0;
+    Time next;                                             // date du prochain relevé programmé
+
+    /**
+     * @brief Prépare les tables et programme le premier relevé.
+     * La taille de l'anneau couvre toute la simulation, dans la limite de maxRecords enregistrements.
+     */
+    void Start(double intervalSeconds, double duration, uint64_t maxRecords, Ptr<FlowMonitor> flowMonitor, Ptr<Ipv4FlowClassifier> flowClassifier)
+    {
+        interval = Seconds(intervalSeconds);
+        monitor = flowMonitor;
+        classifier = flowClassifier;
+        BuildSinkIndex(current, sinkIndex);
+        previous = current;
+        previousSinkRx.assign(current.size(), 0);
+        flowSinks.assign(16 * current.size() + 1024, std::make_pair(-2, -2));
+        uint64_t expected = ((uint64_t)(duration / intervalSeconds) + 1) * current.size();
+        ring.resize(std::max<uint64_t>(1, std::min(expected, maxRecords)));
+        next = interval;
+        Simulator::Schedule(interval, &TimeSeriesSampler::Sample, this);
+    }
+
+    void Sample()
+    {
+        Record();
+        next = Simulator::Now() + interval;
+        Simulator::Schedule(interval, &TimeSeriesSampler::Sample, this);
+    }
+
+    // Après Simulator::Run : un relevé dû à l'instant de l'arrêt n'a pas été exécuté (l'événement Stop, programmé
+    // avant lui à la même date, passe en premier) ; il est pris ici
+    void Flush()
+    {
+        if (next <= Simulator::Now())
+        {
+            Record();
+            next = Simulator::Now() + interval;
+        }
+    }
+
+    void Record()
+    {
+        for (SinkMetrics &m : current)
+        {
+            m.txPackets = m.rxPackets = m.lostPackets = m.txBytes = m.rxBytes = 0;
+            m.delaySum = m.jitterSum = Seconds(0.0);
+        }
+        if (monitor && classifier)
+        {
+            monitor->CheckForLostPackets();
+            for (const auto &kv : monitor->GetFlowStats())
+            {
+                if (kv.first >= flowSinks.size())
+                {
+                    flowSinks.resize(std::max<std::size_t>(2 * flowSinks.size(), kv.first + 1), std::make_pair(-2, -2));
+                }
+                std::pair<int32_t, int32_t> &sinks = flowSinks[kv.first];
+                if (sinks.first == -2)
+                {
+                    // FindFlow parcourt tous les flux : un seul appel par flux
+                    ResolveFlowSinks(sinkIndex, classifier->FindFlow(kv.first), sinks.first, sinks.second);
+                }
+                AccumulateFlowToSinks(current, sinks.first, sinks.second, kv.second);
+            }
+        }
+
+        double now = Simulator::Now().GetSeconds();
+        for (std::size_t i = 0; i < current.size(); ++i)
+        {
+            const SinkMetrics &c = current[i];
+            const SinkMetrics &p = previous[i];
+            uint64_t sinkRx = c.sink ? c.sink->GetTotalRx() : 0;
+            TimeSeriesRecord &r = ring[recorded++ % ring.size()];
+            r.time = now;
+            r.sink = (uint32_t)i;
+            r.sinkRxBytes = sinkRx - previousSinkRx[i];
+            r.txPackets = c.txPackets - p.txPackets;
+            r.rxPackets = c.rxPackets - p.rxPackets;
+            r.lostPackets = c.lostPackets - p.lostPackets;
+            r.rxBytes = c.rxBytes - p.rxBytes;
+            r.delaySumNs = (c.delaySum - p.delaySum).GetNanoSeconds();
+            r.jitterSumNs = (c.jitterSum - p.jitterSum).GetNanoSeconds();
+            previousSinkRx[i] = sinkRx;
+            previous[i].txPackets = c.txPackets;
+            previous[i].rxPackets = c.rxPackets;
+            previous[i].lostPackets = c.lostPackets;
+            previous[i].rxBytes = c.rxBytes;
+            previous[i].delaySum = c.delaySum;
+            previous[i].jitterSum = c.jitterSum;
+        }
+        Simulator::Schedule(interval, &TimeSeriesSampler::Sample, this);
+    }
+
+    // Après FlowMonitor::ResetAllStats (fin du préchauffage) : les cumuls FlowMonitor repartent de zéro
+    void ResetFlowBaselines()
+    {
+        for (SinkMetrics &p : previous)
+        {
+            p.txPackets = p.rxPackets = p.lostPackets = p.txBytes = p.rxBytes = 0;
+            p.delaySum = p.jitterSum = Seconds(0.0);
+        }
+    }
+
+    /**
+     * @brief Écrit la série (une ligne par relevé et par sink), du plus ancien au plus récent enregistrement gardé.
+     * Débit : octets reçus par le sink sur l'intervalle ; perte : paquets déclarés perdus par FlowMonitor
+     * sur l'intervalle rapportés aux paquets émis ; délai et gigue : moyennes des paquets reçus sur l'intervalle.
+     * @return nombre d'enregistrements écrasés faute de place.
+     */
+    uint64_t Write(const std::string &filename) const
+    {
+        std::ofstream out(filename);
+        out << "time,nodeId,port,appType,sinkRxBytes,throughputMbps,txPackets,rxPackets,lostPackets,lossPct,rxBytes,meanDelayMs,meanJitterMs\n";
+        double seconds = interval.GetSeconds();
+        uint64_t first = recorded > ring.size() ? recorded - ring.size() : 0;
+        for (uint64_t n = first; n < recorded; ++n)
+        {
+            const TimeSeriesRecord &r = ring[n % ring.size()];
+            const SinkMetrics &m = current[r.sink];
+            double lossPct = r.txPackets > 0 ? r.lostPackets * 100.0 / r.txPackets : 0.0;
+            double meanDelayMs = r.rxPackets > 0 ? r.delaySumNs / 1e6 / r.rxPackets : 0.0;
+            double meanJitterMs = r.rxPackets > 0 ? r.jitterSumNs / 1e6 / r.rxPackets : 0.0;
+            out << r.time << "," << m.nodeId << "," << m.port << "," << GetAppTypeName(m.port) << "," << r.sinkRxBytes << ","
+                << (r.sinkRxBytes * 8.0) / (seconds * 1000000.0) << "," << r.txPackets << "," << r.rxPackets << ","
+                << r.lostPackets << "," << lossPct << "," << r.rxBytes << "," << meanDelayMs << "," << meanJitterMs << "\n";
+        }
+        return first;
+    }
+};
+
+// --- Préchauffage et régime stationnaire (--warmup, --steadyState) ---
+
+// Fin du préchauffage : ouvre la fenêtre de mesure et remet les compteurs à zéro
+void StartMeasurement(Ptr<FlowMonitor> monitor, TimeSeriesSampler *sampler)
+{
+    g_measureStart = Simulator::Now().GetSeconds();
+    for (const auto &pairNode : g_installedSinks)
+    {
+        for (const auto &pairPort : pairNode.second)
+        {
+            g_sinkRxBaseline[pairNode.first][pairPort.first] = pairPort.second ? pairPort.second->GetTotalRx() : 0;
+        }
+    }
+    if (monitor)
+    {
+        monitor->ResetAllStats();
+    }
+    if (sampler)
+    {
+        sampler->ResetFlowBaselines();
+    }
+    NS_LOG_INFO("Fin du préchauffage à " << g_measureStart << " s : compteurs remis à zéro");
+}
+
+// Détecteur de régime stationnaire par moyennes de lots : le débit de chaque sink est relevé à la fin de
+// chaque lot ; la simulation s'arrête dès que, pour tous les sinks, au moins minBatches lots ont été
+// observés, la moyenne des lots est non nulle et la demi-largeur de son IC à 95 % est sous tolerance * moyenne.
+// Un sink qui ne reçoit rien empêche donc l'arrêt anticipé : la simulation va alors jusqu'à --duration.
+struct SteadyStateDetector
+{
+    Time batch;
+    double tolerance = 0.05;
+    uint32_t minBatches = 10;
+    std::vector<SinkMetrics> sinks;
+    std::vector<uint64_t> lastRx;
+    std::vector<RunningStat> throughput;
+    uint32_t batches = 0;
+    bool converged = false;
+
+    void Start(double startTime, const ScenarioConfig &config)
+    {
+        batch = Seconds(config.steadyBatch);
+        tolerance = config.steadyTolerance;
+        minBatches = std::max<uint32_t>(2, config.steadyMinBatches);
+        std::unordered_map<uint64_t, std::size_t> index;
+        BuildSinkIndex(sinks, index);
+        lastRx.assign(sinks.size(), 0);
+        throughput.assign(sinks.size(), RunningStat());
+        Simulator::Schedule(Seconds(startTime), &SteadyStateDetector::Begin, this);
+    }
+
+    void Begin()
+    {
+        for (std::size_t i = 0; i < sinks.size(); ++i)
+        {
+            lastRx[i] = sinks[i].sink ? sinks[i].sink->GetTotalRx() : 0;
+        }
+        Simulator::Schedule(batch, &SteadyStateDetector::EndBatch, this);
+    }
+
+    void EndBatch()
+    {
+        ++batches;
+        bool allConverged = true;
+        for (std::size_t i = 0; i < sinks.size(); ++i)
+        {
+            uint64_t rx = sinks[i].sink ? sinks[i].sink->GetTotalRx() : 0;
+            throughput[i].Add((rx - lastRx[i]) * 8.0 / (batch.GetSeconds() * 1000000.0));
+            lastRx[i] = rx;
+            const RunningStat &stat = throughput[i];
+            // Un sink sans trafic (moyenne nulle) n'est jamais considéré comme convergé : 0 <= 0 n'est pas une convergence
+            allConverged = allConverged && stat.n >= minBatches && stat.mean > 0 && stat.HalfWidth() <= tolerance * stat.mean;
+        }
+        if (allConverged)
+        {
+            converged = true;
+            std::cout << "Régime stationnaire atteint à " << Simulator::Now().GetSeconds() << " s (" << batches
+                      << " lots de " << batch.GetSeconds() << " s) : arrêt anticipé de la simulation" << std::endl;
+            Simulator::Stop();
+            return;
+        }
+        Simulator::Schedule(batch, &SteadyStateDetector::EndBatch, this);
+    }
+};
+
+// --- Extraction en ligne des caractéristiques ML (--enableMlFeatures) ---
+// Remplace la chaîne --enablePcap + pcap_to_dataset.py : les sources de trace Tx/Rx d'Ipv4L3Protocol,
+// celles qu'utilise EnablePcapIpv4All, alimentent directement un accumulateur par (nœud, interface, label).
+// Seule la fenêtre en cours de chaque accumulateur est gardée ; une fenêtre close devient une ligne du dataset.
+struct MlFeatureCollector
+{
+    // Une fenêtre : trace (nœud, interface) d'origine et rang de premier paquet, pour l'ordre des lignes
+    struct Row
+    {
+        uint64_t trace;
+        uint64_t order;
+        ChunkAccumulator acc;
+    };
+
+    double chunkSize = ML_CHUNK_SIZE;
+    std::unordered_map<uint64_t, Row> active;   // clé : nœud (24 bits), interface (32 bits), label (8 bits)
+    std::vector<Row> closed;
+    uint64_t nextOrder = 0;
+    uint8_t buffer[64];                         // en-têtes IPv4 + ports, copiés sans sérialiser la charge utile
+
+    void OnPacket(uint32_t nodeId, Ptr<const Packet> packet, uint32_t interface)
+    {
+        uint32_t len = packet->CopyData(buffer, sizeof(buffer));
+        uint8_t proto;
+        uint16_t sport, dport;
+        if (!ParseIpv4Ports(buffer, len, proto, sport, dport))
+        {
+            return;
+        }
+        int label = PortsToLabel(sport, dport);
+        if (label == 0)
+        {
+            return;
+        }
+
+        // Même résolution (µs) que les horodatages des traces pcap
+        int64_t us = Simulator::Now().GetMicroSeconds();
+        double time = (double)(us / 1000000) + (double)(us % 1000000) / 1e6;
+        int64_t chunkIdx = MlChunkIndex(time, chunkSize);
+        uint64_t trace = ((uint64_t)nodeId << 32) | interface;
+        uint64_t key = ((uint64_t)nodeId << 40) | ((uint64_t)interface << 8) | (uint64_t)label;
+
+        auto it = active.find(key);
+        if (it == active.end())
+        {
+            it = active.emplace(key, Row{trace, nextOrder++, ChunkAccumulator()}).first;
+            it->second.acc.label = label;
+            it->second.acc.chunkIdx = chunkIdx;
+        }
+        else if (it->second.acc.chunkIdx != chunkIdx)
+        {
+            closed.push_back(it->second);
+            it->second.order = nextOrder++;
+            it->second.acc = ChunkAccumulator();
+            it->second.acc.label = label;
+            it->second.acc.chunkIdx = chunkIdx;
+        }
+        it->second.acc.Add(time, packet->GetSize(), proto == 6);
+    }
+
+    // Branche le collecteur sur tous les nœuds IPv4 (comme EnablePcapIpv4All : toutes les interfaces)
+    void Install()
+    {
+        for (uint32_t i = 0; i < NodeList::GetNNodes(); ++i)
+        {
+            Ptr<Node> node = NodeList::GetNode(i);
+            Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+            if (ipv4)
+            {
+                ipv4->TraceConnectWithoutContext("Tx", MakeBoundCallback(&MlFeatureTrace, this, node->GetId()));
+                ipv4->TraceConnectWithoutContext("Rx", MakeBoundCallback(&MlFeatureTrace, this, node->GetId()));
+            }
+        }
+    }
+
+    static void MlFeatureTrace(MlFeatureCollector *collector, uint32_t nodeId, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+    {
+        collector->OnPacket(nodeId, packet, interface);
+    }
+
+    /**
+     * @brief Ferme les fenêtres en cours et écrit le dataset (schéma de dataset_ml_features.csv).
+     * Lignes groupées par trace (nœud, interface) puis dans l'ordre d'apparition des fenêtres,
+     * comme pcap_to_dataset.py le fait fichier par fichier.
+     * @return nombre de lignes écrites.
+     */
+    uint64_t Write(const std::string &filename)
+    {
+        for (auto &entry : active)
+        {
+            closed.push_back(entry.second);
+        }
+        active.clear();
+        std::sort(closed.begin(), closed.end(), [](const Row &a, const Row &b) {
+            return a.trace != b.trace ? a.trace < b.trace : a.order < b.order;
+        });
+
+        std::ofstream csv(filename);
+        WriteMlFeaturesHeader(csv);
+        for (const Row &row : closed)
+        {
+            WriteMlFeaturesRow(csv, row.acc);
+        }
+        return closed.size();
+    }
+};
+
+
+// --- Capture PCAP sélective (--pcapInterfaces, --pcapPorts, --pcapProtocol, --pcapSnapLen) ---
+// EnablePcapIpv4All trace toutes les interfaces de tous les nœuds : chaque paquet est écrit une fois
+// par interface traversée. Ce mode n'ouvre un fichier trace-ml-ip-<nœud>-<interface>.pcap (même nom et
+// même format que EnablePcapIpv4All, donc lisible par pcap-to-dataset) que pour les interfaces choisies,
+// et n'y écrit que les paquets retenus par le filtre, tronqués à pcapSnapLen octets.
+struct PcapCapture
+{
+    std::vector<std::pair<uint16_t, uint16_t>> portRanges;   // vide : tous les ports
+    uint8_t protocol = 0;                                    // 0 : TCP, UDP et autres ; 6 : TCP ; 17 : UDP
+    std::map<uint32_t, std::vector<int32_t>> files;   // nœud -> fichier par interface (-1 si non capturée)
+    std::vector<Ptr<PcapFileWrapper>> wrappers;        // fichiers écrits directement (sans --asyncTraces)
+    AsyncTraceWriter *writer = nullptr;                // avec --asyncTraces : fichiers écrits par le thread d'écriture
+    uint32_t snapLen = 65535;
+    uint64_t written = 0;
+    uint64_t filtered = 0;
+    uint8_t buffer[64];
+    std::vector<uint8_t> packetBuffer;                 // copie du paquet transmise au thread d'écriture
+
+    bool Filtering() const
+    {
+        return !portRanges.empty() || protocol != 0;
+    }
+
+    bool PortMatches(uint16_t port) const
+    {
+        for (const auto &range : portRanges)
+        {
+            if (port >= range.first && port <= range.second)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Même lecture des en-têtes que l'extraction des caractéristiques ML (simulation-domestique-ml.h)
+    bool Accept(Ptr<const Packet> packet)
+    {
+        if (!Filtering())
+        {
+            return true;
+        }
+        uint32_t len = packet->CopyData(buffer, sizeof(buffer));
+        uint8_t proto;
+        uint16_t sport, dport;
+        if (!ParseIpv4Ports(buffer, len, proto, sport, dport))
+        {
+            return false;
+        }
+        return (protocol == 0 || proto == protocol) &&
+               (portRanges.empty() || PortMatches(sport) || PortMatches(dport));
+    }
+
+    void OnPacket(uint32_t nodeId, Ptr<const Packet> packet, uint32_t interface)
+    {
+        const std::vector<int32_t> &nodeFiles = files[nodeId];
+        if (interface >= nodeFiles.size() || nodeFiles[interface] < 0)
+        {
+            return;
+        }
+        if (!Accept(packet))
+        {
+            ++filtered;
+            return;
+        }
+        if (writer)
+        {
+            // Enregistrement pcap (horodatage en µs, longueurs capturée et réelle) puis octets du paquet
+            uint32_t inclLen = std::min(packet->GetSize(), snapLen);
+            packet->CopyData(packetBuffer.data(), inclLen);
+            int64_t us = Simulator::Now().GetMicroSeconds();
+            uint32_t record[4] = {(uint32_t)(us / 1000000), (uint32_t)(us % 1000000), inclLen, packet->GetSize()};
+            writer->Write(nodeFiles[interface], record, sizeof(record), packetBuffer.data(), inclLen);
+        }
+        else
+        {
+            wrappers[nodeFiles[interface]]->Write(Simulator::Now(), packet);
+        }
+        ++written;
+    }
+
+    static void PcapTrace(PcapCapture *capture, uint32_t nodeId, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+    {
+        capture->OnPacket(nodeId, packet, interface);
+    }
+
+    // Ouvre le fichier d'une interface ; la source de trace du nœud est connectée à sa première interface
+    void AddInterface(Ptr<Node> node, uint32_t interface, const std::string &prefix)
+    {
+        Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+        NS_ABORT_MSG_IF(!ipv4 || interface >= ipv4->GetNInterfaces(),
+                        "--pcapInterfaces : interface " << interface << " absente du nœud " << node->GetId());
+        auto it = files.find(node->GetId());
+        if (it == files.end())
+        {
+            it = files.emplace(node->GetId(), std::vector<int32_t>(ipv4->GetNInterfaces(), -1)).first;
+            ipv4->TraceConnectWithoutContext("Tx", MakeBoundCallback(&PcapTrace, this, node->GetId()));
+            ipv4->TraceConnectWithoutContext("Rx", MakeBoundCallback(&PcapTrace, this, node->GetId()));
+        }
+        if (it->second[interface] < 0)
+        {
+            std::ostringstream name;
+            name << prefix << "-" << node->GetId() << "-" << interface << ".pcap";
+            if (writer)
+            {
+                // En-tête global pcap (µs, IPv4 brut), comme PcapHelper::CreateFile
+                int32_t file = writer->Open(name.str());
+                NS_ABORT_MSG_IF(file < 0, "Impossible d'ouvrir " << name.str());
+                uint32_t header[6] = {0xa1b2c3d4, 2 | (4 << 16), 0, 0, snapLen, PcapHelper::DLT_RAW};
+                writer->Write(file, header, sizeof(header));
+                packetBuffer.resize(snapLen);
+                it->second[interface] = file;
+            }
+            else
+            {
+                PcapHelper pcapHelper;
+                wrappers.push_back(pcapHelper.CreateFile(name.str(), std::ios::out, PcapHelper::DLT_RAW, snapLen));
+                it->second[interface] = (int32_t)(wrappers.size() - 1);
+            }
+        }
+    }
+
+    // Toutes les interfaces d'un nœud, hors boucle locale (interface 0)
+    void AddNode(Ptr<Node> node, const std::string &prefix)
+    {
+        Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+        NS_ABORT_MSG_IF(!ipv4, "--pcapInterfaces : le nœud " << node->GetId() << " n'a pas de pile IPv4");
+        for (uint32_t i = 1; i < ipv4->GetNInterfaces(); ++i)
+        {
+            AddInterface(node, i, prefix);
+        }
+    }
+};
+
+// Découpe une liste "a|b|c" ; une liste vide donne une liste vide
+std::vector<std::string> SplitList(const std::string &text, char sep)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, sep))
+    {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// Lit une liste de ports "9001-9011,80" (intervalles ou ports isolés)
+std::vector<std::pair<uint16_t, uint16_t>> ParsePortRanges(const std::string &spec)
+{
+    std::vector<std::pair<uint16_t, uint16_t>> ranges;
+    for (const std::string &item : SplitList(spec, ','))
+    {
+        unsigned long first = 0, last = 0;
+        char *end = nullptr;
+        first = std::strtoul(item.c_str(), &end, 10);
+        last = first;
+        if (*end == '-')
+        {
+            last = std::strtoul(end + 1, &end, 10);
+        }
+        NS_ABORT_MSG_IF(end == item.c_str() || *end != '\0' || first > last || last > 65535,
+                        "--pcapPorts : intervalle invalide '" << item << "'");
+        ranges.emplace_back((uint16_t)first, (uint16_t)last);
+    }
+    return ranges;
+}
+
+// --- Cache des pertes et délais de propagation (--propagationCache) ---
+
+/**
+ * @brief Table dense (émetteur, récepteur) -> valeur, pour des positions fixes.
+ * Chaque modèle de mobilité reçoit un indice à sa première apparition (au plus capacity, au-delà la valeur
+ * est recalculée à chaque appel) ; un changement de position (trace CourseChange) invalide sa ligne et sa colonne.
+ * La table n'est pas allouée d'avance : son côté double quand un nouvel indice la dépasse (sans dépasser capacity),
+ * la mémoire suit donc le nombre de nœuds qui émettent ou reçoivent réellement.
+ */
+struct StaticLinkCache
+{
+    uint32_t capacity = 0;        // nombre maximal de nœuds indexés
+    uint32_t stride = 0;          // côté de la table allouée
+    std::vector<double> values;   // stride x stride, NaN : valeur à calculer
+    std::unordered_map<const MobilityModel *, uint32_t> indexes;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    void Reserve(uint32_t n)
+    {
+        capacity = n;
+        stride = 0;
+        values.clear();
+        indexes.clear();
+    }
+
+    // Agrandit la table pour contenir l'indice needed - 1, en recopiant les valeurs déjà calculées
+    void Grow(uint32_t needed)
+    {
+        uint32_t grownStride = std::min(capacity, std::max({needed, 2 * stride, 64u}));
+        std::vector<double> grown((std::size_t)grownStride * grownStride, NAN);
+        for (uint32_t i = 0; i < stride; ++i)
+        {
+            std::copy_n(values.begin() + (std::size_t)i * stride, stride, grown.begin() + (std::size_t)i * grownStride);
+        }
+        values.swap(grown);
+        stride = grownStride;
+    }
+
+    uint32_t IndexOf(Ptr<MobilityModel> mobility)
+    {
+        auto it = indexes.find(PeekPointer(mobility));
+        if (it != indexes.end())
+        {
+            return it->second;
+        }
+        if (indexes.size() >= capacity)
+        {
+            return capacity;
+        }
+        uint32_t index = indexes.size();
+        if (index >= stride)
+        {
+            Grow(index + 1);
+        }
+        indexes.emplace(PeekPointer(mobility), index);
+        mobility->TraceConnectWithoutContext("CourseChange", MakeCallback(&StaticLinkCache::OnCourseChange, this));
+        return index;
+    }
+
+    void OnCourseChange(Ptr<const MobilityModel> mobility)
+    {
+        auto it = indexes.find(PeekPointer(mobility));
+        if (it == indexes.end())
+        {
+            return;
+        }
+        for (uint32_t k = 0; k < stride; ++k)
+        {
+            values[(std::size_t)it->second * stride + k] = NAN;
+            values[(std::size_t)k * stride + it->second] = NAN;
+        }
+    }
+
+    template <typename Compute>
+    double Get(Ptr<MobilityModel> a, Ptr<MobilityModel> b, const Compute &compute)
+    {
+        uint32_t i = IndexOf(a);
+        uint32_t j = IndexOf(b);
+        if (i == capacity || j == capacity)
+        {
+            ++misses;
+            return compute();
+        }
+        double &value = values[(std::size_t)i * stride + j];
+        if (std::isnan(value))
+        {
+            ++misses;
+            value = compute();
+        }
+        else
+        {
+            ++hits;
+        }
+        return value;
+    }
+
+    double HitRate() const
+    {
+        return hits + misses > 0 ? (double)hits / (hits + misses) : 0.0;
+    }
+};
+
+/**
+ * @brief Pertes de propagation d'un modèle déterministe (et de sa chaîne), mémorisées par lien.
+ * La perte en dB ne dépend pas de la puissance émise pour les modèles utilisés ici (LogDistance).
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::CachedPropagationLossModel")
+                                .SetParent<PropagationLossModel>()
+                                .SetGroupName("Propagation")
+                                .AddConstructor<CachedPropagationLossModel>();
+        return tid;
+    }
+
+    // maxNodes : nombre de modèles de mobilité couverts par la table (8 * maxNodes^2 octets)
+    void SetModel(Ptr<PropagationLossModel> model, uint32_t maxNodes)
+    {
+        m_model = model;
+        m_cache.Reserve(maxNodes);
+    }
+
+    const StaticLinkCache &GetCache() const
+    {
+        return m_cache;
+    }
+
+  private:
+    double DoCalcRxPower(double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const override
+    {
+        return txPowerDbm - m_cache.Get(a, b, [&]() { return txPowerDbm - m_model->CalcRxPower(txPowerDbm, a, b); });
+    }
+
+    int64_t DoAssignStreams(int64_t stream) override
+    {
+        return m_model->AssignStreams(stream);
+    }
+
+    Ptr<PropagationLossModel> m_model;
+    mutable StaticLinkCache m_cache;
+};
+
+/**
+ * @brief Délais de propagation d'un modèle déterministe, mémorisés par lien.
+ */
+class CachedPropagationDelayModel : public PropagationDelayModel
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::CachedPropagationDelayModel")
+                                .SetParent<PropagationDelayModel>()
+                                .SetGroupName("Propagation")
+                                .AddConstructor<CachedPropagationDelayModel>();
+        return tid;
+    }
+
+    void SetModel(Ptr<PropagationDelayModel> model, uint32_t maxNodes)
+    {
+        m_model = model;
+        m_cache.Reserve(maxNodes);
+    }
+
+    const StaticLinkCache &GetCache() const
+    {
+        return m_cache;
+    }
+
+    Time GetDelay(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const override
+    {
+        return TimeStep((uint64_t)m_cache.Get(a, b, [&]() { return (double)m_model->GetDelay(a, b).GetTimeStep(); }));
+    }
+
+  private:
+    int64_t DoAssignStreams(int64_t stream) override
+    {
+        return m_model->AssignStreams(stream);
+    }
+
+    Ptr<PropagationDelayModel> m_model;
+    mutable StaticLinkCache m_cache;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationDelayModel);
+
+// --- Filtrage des réceptions hors de portée (canal spectrum, --rxCulling) ---
+
+/**
+ * @brief Filtre d'émission du canal spectrum : écarte, avant la création de tout événement, les récepteurs
+ * dont la puissance reçue reste sous le seuil de réception même à la puissance d'émission maximale.
+ * La puissance d'émission maximale (TxPowerEnd + TxGain) est relevée sur les PHY installés, le gain du récepteur
+ * (RxGain) et, par défaut, son seuil (RxSensitivity) sont lus sur le PHY récepteur : le filtre suit les
+ * attributs de WifiPhy. Les positions étant fixes (ConstantPositionMobilityModel), la puissance reçue d'un lien
+ * n'est calculée qu'une fois, à sa première émission ; les réceptions écartées ne comptent plus comme interférences.
+ * Tant que Configure n'a pas été appelé, rien n'est écarté.
+ */
+class ReceiverCullingFilter : public SpectrumTransmitFilter
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::ReceiverCullingFilter")
+                                .SetParent<SpectrumTransmitFilter>()
+                                .SetGroupName("Spectrum")
+                                .AddConstructor<ReceiverCullingFilter>();
+        return tid;
+    }
+
+    // loss : le modèle de pertes du canal ; maxTxPowerDbm : puissance d'émission maximale des PHY, gain d'antenne
+    // compris ; thresholdDbm : seuil commun, ou NaN pour la RxSensitivity de chaque récepteur
+    void Configure(Ptr<PropagationLossModel> loss, double maxTxPowerDbm, double thresholdDbm)
+    {
+        m_loss = loss;
+        m_maxTxPowerDbm = maxTxPowerDbm;
+        m_thresholdDbm = thresholdDbm;
+    }
+
+    uint64_t GetChecked() const
+    {
+        return m_checked;
+    }
+
+    uint64_t GetCulled() const
+    {
+        return m_culled;
+    }
+
+    std::size_t GetLinks() const
+    {
+        return m_rxMarginDb.size();
+    }
+
+  protected:
+    bool DoFilter(Ptr<const SpectrumSignalParameters> params, Ptr<const SpectrumPhy> receiverPhy) const override
+    {
+        ++m_checked;
+        Ptr<MobilityModel> txMobility = params->txPhy ? params->txPhy->GetMobility() : nullptr;
+        Ptr<MobilityModel> rxMobility = receiverPhy->GetMobility();
+        if (!m_loss || !txMobility || !rxMobility)
+        {
+            return false;
+        }
+        uint64_t key = ((uint64_t)params->txPhy->GetDevice()->GetNode()->GetId() << 32) | receiverPhy->GetDevice()->GetNode()->GetId();
+        auto it = m_rxMarginDb.find(key);
+        if (it == m_rxMarginDb.end())
+        {
+            // Marge du lien au-dessus du seuil du récepteur, avec son gain d'antenne
+            double rxGainDb = 0.0;
+            double thresholdDbm = m_thresholdDbm;
+            Ptr<WifiNetDevice> rxDevice = DynamicCast<WifiNetDevice>(receiverPhy->GetDevice());
+            Ptr<WifiPhy> rxWifiPhy = rxDevice ? rxDevice->GetPhy() : nullptr;
+            if (rxWifiPhy)
+            {
+                rxGainDb = rxWifiPhy->GetRxGain();
+                if (std::isnan(thresholdDbm))
+                {
+                    thresholdDbm = rxWifiPhy->GetRxSensitivity();
+                }
+            }
+            if (std::isnan(thresholdDbm))
+            {
+                // PHY inconnu et pas de seuil explicite : le lien n'est jamais écarté
+                return false;
+            }
+            double rxPowerDbm = m_loss->CalcRxPower(m_maxTxPowerDbm, txMobility, rxMobility) + rxGainDb;
+            it = m_rxMarginDb.emplace(key, rxPowerDbm - thresholdDbm).first;
+        }
+        bool culled = it->second < 0.0;
+        m_culled += culled ? 1 : 0;
+        return culled;
+    }
+
+  private:
+    Ptr<PropagationLossModel> m_loss;
+    double m_maxTxPowerDbm = 0.0;
+    double m_thresholdDbm = std::numeric_limits<double>::quiet_NaN();
+    mutable std::unordered_map<uint64_t, double> m_rxMarginDb;   // (nœud émetteur, nœud récepteur) -> puissance reçue - seuil
+    mutable uint64_t m_checked = 0;
+    mutable uint64_t m_culled = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ReceiverCullingFilter);
+
+/**
+ * @brief Canaux 5 GHz sans recouvrement mutuel pour une largeur de canal donnée (20, 40, 80 ou 160 MHz).
+ */
+const std::vector<uint16_t> &GetWifiChannelNumbers(uint16_t width)
+{
+    static const std::map<uint16_t, std::vector<uint16_t>> channels = {
+        {20, {36, 40, 44, 48, 52, 56, 60, 64, 100, 104, 108, 112, 116, 120, 124, 128, 132, 136, 140, 144, 149, 153, 157, 161, 165}},
+        {40, {38, 46, 54, 62, 102, 110, 118, 126, 134, 142, 151, 159}},
+        {80, {42, 58, 106, 122, 138, 155}},
+        {160, {50, 114}},
+    };
+    auto it = channels.find(width);
+    NS_ABORT_MSG_IF(it == channels.end(), "Largeur de canal Wi-Fi non prise en charge : " << width << " MHz (20, 40, 80 ou 160)");
+    return it->second;
+}
+
+void RunSimulation(const ScenarioConfig &config, const OutputOptions &outputs)
+{
+    DUREE_SIMULATION = config.duration;
+    NS_ABORT_MSG_IF(config.warmup < 0 || config.warmup >= config.duration, "--warmup doit être compris entre 0 et la durée de la simulation");
+    g_measureStart = 0.0;
+    g_measureEnd = config.duration;
+    g_sinkRxBaseline.clear();
+    const HouseholdMix &mix = config.mix;
+
+    // Mesure du coût de construction du scénario (temps et mémoire par nœud)
+    uint32_t nEquipments = mix.Total();
+    NS_ABORT_MSG_IF(nEquipments == 0, "Le foyer doit contenir au moins un équipement");
+    auto setupStart = std::chrono::steady_clock::now();
+    uint64_t rssBeforeKb = GetResidentMemoryKb();
+
+    // Un AP par BSS. Avec un seul AP, les serveurs lui sont reliés directement (maison de référence) ;
+    // au-delà, un routeur de collecte relie chaque AP (lien point-à-point) aux serveurs.
+    uint32_t nAps = config.aps;
+    NS_ABORT_MSG_IF(nAps == 0, "--aps doit valoir au moins 1");
+    NS_ABORT_MSG_IF(g_systemCount > 1 && nAps < g_systemCount, "--mpi : il faut au moins un BSS (--aps) par processus");
+    NS_ABORT_MSG_IF(g_systemCount > 1 && outputs.enableFlowMonitor, "--mpi : FlowMonitor ne suit pas les paquets d'un processus à l'autre");
+    // En multithread, les logements s'exécutent en parallèle : tout état écrit par plusieurs logements
+    // (FlowMonitor, traces PCAP et ML, relevés, préchauffage, arrêt anticipé, caches) en est exclu
+    NS_ABORT_MSG_IF(g_multithreaded && (outputs.enableFlowMonitor || outputs.enablePcap || outputs.enableMlFeatures || outputs.sampleInterval > 0 ||
+                                        config.warmup > 0 || config.steadyState || config.propagationCache || config.rxCulling),
+                    "--mtp : FlowMonitor, PCAP, ML, séries temporelles, préchauffage, régime stationnaire et caches de propagation non pris en charge");
+    NS_ABORT_MSG_IF(g_multithreaded && nAps < 2, "--mtp : il faut plusieurs logements (--aps)");
+
+    // Placement avec plusieurs AP : chaque station est posée au hasard dans le bâtiment (pièce et étage)
+    // et rattachée à l'AP le plus proche
+    HomeLayout layout;
+    std::vector<LayoutPosition> stationPositions;
+    std::vector<uint32_t> stationBss(nEquipments, 0);
+    if (nAps > 1)
+    {
+        layout = BuildHomeLayout(nAps, config.floors, config.roomSize, config.floorHeight);
+        // Stations dans l'ordre des clients (type, puis rang dans le type) ; avec --fixedStreams, chacune tire
+        // sa position dans son propre flux : ajouter un équipement ne déplace pas les autres
+        Ptr<UniformRandomVariable> placement = CreateObject<UniformRandomVariable>();
+        uint32_t i = 0;
+        for (uint32_t type = 0; type < ProfileCount(); ++type)
+        {
+            for (uint32_t rank = 0; rank < mix.counts[type]; ++rank, ++i)
+            {
+                if (config.fixedStreams)
+                {
+                    placement->SetStream(EquipmentStream(type, rank, STREAM_PLACEMENT));
+                }
+                LayoutPosition p;
+                p.x = placement->GetValue(0.0, layout.Width());
+                p.y = placement->GetValue(0.0, layout.Depth());
+                p.z = layout.StationHeight(placement->GetInteger(0, layout.floors - 1));
+                stationPositions.push_back(p);
+                stationBss[i] = NearestAp(layout, p);
+            }
+        }
+    }
+
+    // --- 1. Création des Nœuds ---
+    // En exécution distribuée, chaque BSS (AP et stations) appartient à un processus, à tour de rôle ;
+    // serveurs et routeur de collecte sont sur le processus 0. Seuls les liens de collecte (1 ms) relient
+    // deux processus : leur délai est l'horizon (lookahead) de la synchronisation conservative.
+    NodeContainer clientNodes;
+    for (uint32_t i = 0; i < nEquipments; ++i)
+    {
+        clientNodes.Add(CreateObject<Node> (stationBss[i] % g_systemCount));
+    }
+
+    NodeContainer serverNodes;
+    serverNodes.Create (ProfileCount()); 
+
+    NodeContainer apNodes;
+    for (uint32_t b = 0; b < nAps; ++b)
+    {
+        apNodes.Add(CreateObject<Node> (b % g_systemCount));
+    }
+    Ptr<Node> coreNode = apNodes.Get(0);
+    if (nAps > 1)
+    {
+        coreNode = CreateObject<Node> ();
+    }
+
+    // --- 2. Configuration du Canal Wi-Fi & Mobilité ---
+    // Les BSS sont répartis à tour de rôle sur wifiChannels canaux sans recouvrement (GetWifiChannelNumbers).
+    // Yans : un YansWifiChannel par canal, une émission n'est remise qu'aux PHY de son canal.
+    // Spectrum : un seul MultiModelSpectrumChannel, dont le WifiBandwidthFilter écarte avant tout événement
+    // les récepteurs dont la bande ne recouvre pas celle de l'émission.
+    // Logements isolés (--isolatedHomes) : un objet canal par BSS, les BSS ne se brouillent plus entre eux
+    // et ne sont couplés que par les liens de collecte.
+    NS_ABORT_MSG_IF(config.channelModel != "yans" && config.channelModel != "spectrum", "--channelModel doit valoir yans ou spectrum");
+    const std::vector<uint16_t> &channelNumbers = GetWifiChannelNumbers(config.wifiChannelWidth);
+    NS_ABORT_MSG_IF(config.wifiChannels == 0 || config.wifiChannels > channelNumbers.size(),
+                    "--wifiChannels doit être compris entre 1 et " << channelNumbers.size() << " pour des canaux de " << config.wifiChannelWidth << " MHz");
+    uint32_t nChannels = std::min(config.wifiChannels, nAps);
+    bool spectrum = config.channelModel == "spectrum";
+
+    NS_ABORT_MSG_IF(config.rxCulling && !spectrum, "--rxCulling nécessite --channelModel=spectrum");
+
+    YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default();
+    std::vector<Ptr<YansWifiChannel>> yansChannels;
+    std::vector<Ptr<MultiModelSpectrumChannel>> spectrumChannels;
+    std::vector<Ptr<ReceiverCullingFilter>> cullingFilters;
+    uint32_t nChannelObjects = config.isolatedHomes ? nAps : (spectrum ? 1 : nChannels);
+
+    // Mêmes modèles que YansWifiChannelHelper::Default() ; avec --propagationCache, pertes et délais sont
+    // mémorisés par lien (les positions sont fixes) et ces modèles sont partagés par tous les canaux
+    Ptr<PropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel>();
+    Ptr<PropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+    Ptr<CachedPropagationLossModel> cachedLoss;
+    Ptr<CachedPropagationDelayModel> cachedDelay;
+    if (config.propagationCache)
+    {
+        // Au plus 4096 nœuds dans la table (2 x 128 Mo), allouée au fil des nœuds rencontrés ; les liens des suivants
+        // sont recalculés à chaque trame
+        uint32_t wifiNodes = std::min<uint32_t>(nEquipments + nAps, 4096);
+        cachedLoss = CreateObject<CachedPropagationLossModel>();
+        cachedLoss->SetModel(loss, wifiNodes);
+        cachedDelay = CreateObject<CachedPropagationDelayModel>();
+        cachedDelay->SetModel(delay, wifiNodes);
+        loss = cachedLoss;
+        delay = cachedDelay;
+    }
+
+    if (spectrum)
+    {
+        for (uint32_t c = 0; c < nChannelObjects; ++c)
+        {
+            Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel>();
+            spectrumChannel->AddPropagationLossModel(loss);
+            spectrumChannel->SetPropagationDelayModel(delay);
+            spectrumChannel->AddSpectrumTransmitFilter(CreateObject<WifiBandwidthFilter>());
+            if (config.rxCulling)
+            {
+                // Après le filtre de bande : seules les réceptions sur le même canal sont évaluées ;
+                // configuré une fois les PHY installés
+                Ptr<ReceiverCullingFilter> cullingFilter = CreateObject<ReceiverCullingFilter>();
+                spectrumChannel->AddSpectrumTransmitFilter(cullingFilter);
+                cullingFilters.push_back(cullingFilter);
+            }
+            spectrumChannels.push_back(spectrumChannel);
+        }
+    }
+    else
+    {
+        for (uint32_t c = 0; c < nChannelObjects; ++c)
+        {
+            yansChannels.push_back(channelHelper.Create());
+            if (config.propagationCache)
+            {
+                yansChannels.back()->SetPropagationLossModel(loss);
+                yansChannels.back()->SetPropagationDelayModel(delay);
+            }
+        }
+    }
+    
+    // Piste d'amélioration : modèle de propagation plus réaliste pour le domaine
+    // channelHelper.AddPropagationLoss("ns3::LogDistancePropagationLossModel", 
+    //                                  "Exponent", DoubleValue(3.0)); // Ajout de murs/distance
+    
+    YansWifiPhyHelper yansPhyHelper;
+    SpectrumWifiPhyHelper spectrumPhyHelper;
+    WifiPhyHelper &phyHelper = spectrum ? static_cast<WifiPhyHelper &>(spectrumPhyHelper) : yansPhyHelper;
+   
+    // Piste d'amélioration : configuration de la sensibilité du récepteur (si vous étudiez la portée)
+    // phyHelper.Set("EnergyDetectionThreshold", DoubleValue(-96.0));
+    
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(apNodes);
+    mobility.Install(clientNodes);
+    mobility.Install(serverNodes); 
+
+    // Stations de chaque BSS : toutes celles de la maison avec un seul AP
+    std::vector<NodeContainer> bssStations(nAps);
+    if (nAps == 1)
+    {
+        bssStations[0] = clientNodes;
+    }
+    else
+    {
+        for (uint32_t b = 0; b < nAps; ++b)
+        {
+            const LayoutPosition &p = layout.aps[b];
+            apNodes.Get(b)->GetObject<MobilityModel>()->SetPosition(Vector(p.x, p.y, p.z));
+        }
+        for (uint32_t i = 0; i < nEquipments; ++i)
+        {
+            const LayoutPosition &p = stationPositions[i];
+            clientNodes.Get(i)->GetObject<MobilityModel>()->SetPosition(Vector(p.x, p.y, p.z));
+            bssStations[stationBss[i]].Add(clientNodes.Get(i));
+        }
+    }
+    
     // --- 3. Configuration Wi-Fi ---
     WifiHelper wifiHelper;
-    if (forceAc)
+    if (config.forceAc)
+    {
+        wifiHelper.SetStandard(WIFI_STANDARD_80211ac);
+        NS_LOG_INFO("J'impose le standard Wi‑Fi : 802.11ac");
+    }
+    else
+    {
+        NS_LOG_INFO("Utilisation du standard Wi‑Fi par défaut (sans contrainte). ");
+    }
+
+    
+    // Utilisation de Minstrel HT manager pour les modes haut débit (supporte HT/VHT), sauf choix contraire (--rateManager)
+    wifiHelper.SetRemoteStationManager(config.rateManager);
+
+    
+    WifiMacHelper macHelper;
+
+    // Un SSID par BSS : a) l'AP, b) ses stations
+    NetDeviceContainer apDevices;
+    std::vector<NetDeviceContainer> bssDevices(nAps);
+    NetDeviceContainer clientDevices;
+    SimpleNetDeviceHelper shadowHelper;
+    for (uint32_t b = 0; b < nAps; ++b)
+    {
+        if (apNodes.Get(b)->GetSystemId() != g_systemId)
+        {
+            // BSS d'un autre processus : simple reflet sans Wi-Fi (aucun événement ici), adressé comme le vrai BSS
+            // pour que tous les processus calculent les mêmes routes
+            NetDeviceContainer shadow = shadowHelper.Install(NodeContainer(NodeContainer(apNodes.Get(b)), bssStations[b]));
+            apDevices.Add(shadow.Get(0));
+            for (uint32_t k = 1; k < shadow.GetN(); ++k)
+            {
+                bssDevices[b].Add(shadow.Get(k));
+            }
+            clientDevices.Add(bssDevices[b]);
+            continue;
+        }
+        // Canal du BSS ; avec un seul canal, le PHY garde son canal par défaut (maison de référence)
+        uint32_t c = b % nChannels;
+        uint32_t channelObject = config.isolatedHomes ? b : (spectrum ? 0 : c);
+        if (spectrum)
+        {
+            spectrumPhyHelper.SetChannel(spectrumChannels[channelObject]);
+        }
+        else
+        {
+            yansPhyHelper.SetChannel(yansChannels[channelObject]);
+        }
+        if (nChannels > 1)
+        {
+            std::ostringstream settings;
+            settings << "{" << channelNumbers[c] << ", " << config.wifiChannelWidth << ", BAND_5GHZ, 0}";
+            phyHelper.Set("ChannelSettings", StringValue(settings.str()));
+        }
+        Ssid ssid = Ssid(nAps == 1 ? std::string("MaisonConnectee") : "MaisonConnectee-" + std::to_string(b));
+        macHelper.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+        apDevices.Add(wifiHelper.Install(phyHelper, macHelper, apNodes.Get(b)));
+        macHelper.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+        bssDevices[b] = wifiHelper.Install(phyHelper, macHelper, bssStations[b]);
+        clientDevices.Add(bssDevices[b]);
+    }
+
+    if (!cullingFilters.empty())
+    {
+        // Puissance d'émission maximale, gain d'antenne compris, sur tous les PHY installés (les reflets des BSS
+        // des autres processus n'ont pas de PHY)
+        double maxTxPowerDbm = -std::numeric_limits<double>::infinity();
+        for (const NetDeviceContainer *devices : {&apDevices, &clientDevices})
+        {
+            for (uint32_t i = 0; i < devices->GetN(); ++i)
+            {
+                Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices->Get(i));
+                if (device && device->GetPhy())
+                {
+                    maxTxPowerDbm = std::max(maxTxPowerDbm, device->GetPhy()->GetTxPowerEnd() + device->GetPhy()->GetTxGain());
+                }
+            }
+        }
+        for (const Ptr<ReceiverCullingFilter> &cullingFilter : cullingFilters)
+        {
+            cullingFilter->Configure(loss, maxTxPowerDbm, config.cullThresholdDbm);
+        }
+    }
+
+    // Diagnostic : affichage de la configuration (le reste est inchangé)
+    Ptr<WifiNetDevice> apWifiDev = DynamicCast<WifiNetDevice>(apDevices.Get(0));
+    if (apWifiDev)
+    {
+            NS_LOG_INFO("Type de WifiNetDevice AP : " << apWifiDev->GetInstanceTypeId().GetName());
+        Ptr<WifiPhy> apPhy = apWifiDev->GetPhy();
+        if (apPhy)
+        {
+            NS_LOG_INFO("Type Phy AP : " << apPhy->GetInstanceTypeId().GetName());
+            NS_LOG_INFO("Standard Phy AP configuré : " << apPhy->GetStandard());
+            NS_LOG_INFO("Bande Phy AP : " << apPhy->GetPhyBand());
+        }
+        Ptr<WifiRemoteStationManager> apRsm = apWifiDev->GetRemoteStationManager();
+        if (apRsm)
+        {
+            NS_LOG_INFO("RemoteStationManager AP : " << apRsm->GetInstanceTypeId().GetName());
+        }
+    }
+    Ptr<WifiNetDevice> staWifiDev = DynamicCast<WifiNetDevice>(clientDevices.Get(0));
+    if (staWifiDev)
+    {
+        NS_LOG_INFO("Type de WifiNetDevice STA : " << staWifiDev->GetInstanceTypeId().GetName());
+        Ptr<WifiPhy> staPhy = staWifiDev->GetPhy();
+        if (staPhy)
+        {
+            NS_LOG_INFO("Type Phy STA : " << staPhy->GetInstanceTypeId().GetName());
+            NS_LOG_INFO("Standard Phy STA configuré : " << staPhy->GetStandard());
+            NS_LOG_INFO("Bande Phy STA : " << staPhy->GetPhyBand());
+        }
+        Ptr<WifiRemoteStationManager> staRsm = staWifiDev->GetRemoteStationManager();
+        if (staRsm)
+        {
+            NS_LOG_INFO("RemoteStationManager STA : " << staRsm->GetInstanceTypeId().GetName());
+        }
+    }
+    
+    // --- 4. Configuration Réseau Serveurs (Ethernet) ---
+    PointToPointHelper p2pHelper;
+    p2pHelper.SetDeviceAttribute("DataRate", StringValue("1000Mbps"));
+    p2pHelper.SetChannelAttribute("Delay", StringValue("1ms"));
+    
+    NetDeviceContainer apP2pDevices;
+    NetDeviceContainer serverDevices;
+    std::vector<NetDeviceContainer> p2pLinks;
+
+    
+    Ipv4AddressHelper p2pAddress;
+    p2pAddress.SetBase("10.2.1.0", "255.255.255.0");
+    
+    for (uint32_t i = 0; i < ProfileCount(); ++i)
+    {
+        NetDeviceContainer link = p2pHelper.Install(coreNode, serverNodes.Get(i));
+        apP2pDevices.Add(link.Get(0));
+        serverDevices.Add(link.Get(1));
+        p2pLinks.push_back(link);
+    }
+
+    // Liens de collecte AP - routeur (un /30 chacun dans 10.3.0.0/16)
+    std::vector<NetDeviceContainer> backhaulLinks;
+    for (uint32_t b = 0; nAps > 1 && b < nAps; ++b)
+    {
+        backhaulLinks.push_back(p2pHelper.Install(apNodes.Get(b), coreNode));
+    }
+
+    // --- 5. Installation de la Pile Internet (IP) ---
+    InternetStackHelper stack;
+    stack.Install(apNodes);
+    stack.Install(clientNodes);
+    stack.Install(serverNodes);
+    if (nAps > 1)
+    {
+        stack.Install(coreNode);
+    }
+
+    // Adressage stratégique : 10.1.1.0/24 pour la maison de référence ; au-delà de 253 hôtes (AP + clients),
+    // le sous-réseau Wi-Fi est élargi à partir de 10.1.0.0 (/23 ... /16), sans chevaucher les liens 10.2.x.0.
+    // Avec plusieurs AP, chaque BSS a son sous-réseau (/24, élargi au besoin) pris à la suite dans 10.64.0.0/10.
+    Ipv4AddressHelper address; 
+    if (nAps == 1)
+    {
+        uint32_t wifiHosts = nEquipments + 1;
+        if (wifiHosts <= 253)
+        {
+            address.SetBase ("10.1.1.0", "255.255.255.0"); 
+        }
+        else
+        {
+            uint32_t prefix = 23;
+            while (prefix > 16 && ((1u << (32 - prefix)) - 2) < wifiHosts) --prefix;
+            NS_ABORT_MSG_IF(((1u << (32 - prefix)) - 2) < wifiHosts, "Trop d'équipements pour le sous-réseau Wi-Fi 10.1.0.0/16 : " << nEquipments);
+            std::string mask = "/" + std::to_string(prefix);
+            address.SetBase ("10.1.0.0", mask.c_str()); 
+        }
+
+        // Attribution des adresses IP aux interfaces
+        address.Assign(apDevices);
+        address.Assign(clientDevices);
+    }
+    else
+    {
+        uint32_t bssHosts = 0;
+        for (const NodeContainer &stations : bssStations)
+        {
+            bssHosts = std::max(bssHosts, stations.GetN() + 1);
+        }
+        uint32_t prefix = 24;
+        while (prefix > 16 && ((1u << (32 - prefix)) - 2) < bssHosts) --prefix;
+        NS_ABORT_MSG_IF(((1u << (32 - prefix)) - 2) < bssHosts, "Trop de stations pour un BSS : " << bssHosts - 1);
+        NS_ABORT_MSG_IF(((uint64_t)nAps << (32 - prefix)) > (1u << 22), "Trop de BSS pour l'espace d'adresses 10.64.0.0/10 : " << nAps);
+        std::string mask = "/" + std::to_string(prefix);
+        address.SetBase ("10.64.0.0", mask.c_str()); 
+        Ipv4AddressHelper backhaulAddress;
+        backhaulAddress.SetBase ("10.3.0.0", "255.255.255.252"); 
+        for (uint32_t b = 0; b < nAps; ++b)
+        {
+            address.Assign(NetDeviceContainer(apDevices.Get(b)));
+            address.Assign(bssDevices[b]);
+            address.NewNetwork();
+            backhaulAddress.Assign(backhaulLinks[b]);
+            backhaulAddress.NewNetwork();
+        }
+    }
+
+    // Assigner des adresses IP à chaque lien point-à-point créé plus tôt
+    for (auto &link : p2pLinks)
+    {
+        p2pAddress.Assign(link);
+        p2pAddress.NewNetwork();
+    }
+    
+
+    // Remplissage des tables de routage globales pour permettre le routage entre AP et liens point-à-point
+    auto routingStart = std::chrono::steady_clock::now();
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    double routingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - routingStart).count();
+
+    if (spectrum || nChannels > 1)
+    {
+        std::cout << "Canal Wi-Fi : " << config.channelModel << ", " << nChannels << " canal(aux)";
+        if (nChannels > 1)
+        {
+            std::cout << " de " << config.wifiChannelWidth << " MHz, " << (nAps + nChannels - 1) / nChannels << " BSS max par canal";
+        }
+        std::cout << std::endl;
+    }
+    if (nAps > 1)
+    {
+        uint32_t minStations = nEquipments;
+        uint32_t maxStations = 0;
+        for (const NodeContainer &stations : bssStations)
+        {
+            minStations = std::min(minStations, stations.GetN());
+            maxStations = std::max(maxStations, stations.GetN());
+        }
+        std::cout << "Topologie : " << nAps << " AP sur " << layout.floors << " étage(s) de " << layout.columns << "x" << layout.rows
+                  << " pièces de " << layout.roomSize << " m | stations par AP : min " << minStations << ", moy "
+                  << std::fixed << std::setprecision(1) << (double)nEquipments / nAps << ", max " << maxStations
+                  << " | tables de routage en " << std::setprecision(3) << routingSeconds << " s" << std::endl;
+    }
+    
+    // Débogage : j'affiche les adresses IP 
+    NS_LOG_INFO ("Adresses assignées pour les serveurs et clients :");
+    for (uint32_t i = 0; i < serverNodes.GetN (); ++i)
+    {
+        Ptr<Node> node = serverNodes.Get (i);
+        Ipv4Address addr = GetFirstIpv4Address(node);
+        NS_LOG_INFO ("Serveur " << i << " -> " << addr);
+    }
+    for (uint32_t i = 0; i < clientNodes.GetN (); ++i)
+    {
+        Ptr<Node> node = clientNodes.Get (i);
+        Ipv4Address addr = GetFirstIpv4Address(node);
+        NS_LOG_INFO ("Client " << i << " -> " << addr);
+    }
+    
+
+    // --- 6. Déploiement des Applications ---
+    uint32_t nextClientIndex = 0; 
+    
+    // Configuration de chaque type d'application selon la description du foyer (référence : 5 caméras,
+    // 10 capteurs, 3 assistants vocaux, 2 téléchargements, 4 VoIP, 4 domotiques, 1 streaming, 1 sonnette,
+    // 1 màj firmware, 1 monitoring) ; le type i est servi par serverNodes.Get(i)
+    // Avec --fixedStreams, chaque équipement tire tout ce qui le concerne dans son propre bloc de flux
+    for (uint32_t type = 0; type < ProfileCount(); ++type)
+    {
+        for (uint32_t i = 0; i < mix.counts[type]; ++i)
+        {
+            Ptr<Node> clientNode = clientNodes.Get(nextClientIndex++);
+            int64_t stream = config.fixedStreams ? EquipmentStream(type, i) : -1;
+            if (stream >= 0)
+            {
+                debutAleatoire->SetStream(stream + STREAM_START_TIME);
+            }
+            std::size_t firstSource = g_trafficSources.size();
+            InstallProfile(AppProfiles()[type], clientNode, serverNodes.Get(type), debutAleatoire->GetValue(), stream);
+            if (stream >= 0)
+            {
+                for (std::size_t k = firstSource; k < g_trafficSources.size(); ++k)
+                {
+                    g_trafficSources[k].app->AssignStreams(stream + STREAM_APPLICATIONS + 4 * (k - firstSource));
+                }
+                wifiHelper.AssignStreams(NetDeviceContainer(clientNode->GetDevice(0)), stream + STREAM_WIFI);
+                stack.AssignStreams(NodeContainer(clientNode), stream + STREAM_INTERNET);
+            }
+        }
+    }
+    if (config.fixedStreams)
+    {
+        for (uint32_t b = 0; b < nAps; ++b)
+        {
+            wifiHelper.AssignStreams(NetDeviceContainer(apDevices.Get(b)), InfrastructureStream(INFRA_AP, b, STREAM_WIFI));
+            stack.AssignStreams(NodeContainer(apNodes.Get(b)), InfrastructureStream(INFRA_AP, b, STREAM_INTERNET));
+        }
+        for (uint32_t t = 0; t < ProfileCount(); ++t)
+        {
+            stack.AssignStreams(NodeContainer(serverNodes.Get(t)), InfrastructureStream(INFRA_SERVER, t, STREAM_INTERNET));
+        }
+        if (nAps > 1)
+        {
+            stack.AssignStreams(NodeContainer(coreNode), InfrastructureStream(INFRA_ROUTER, 0, STREAM_INTERNET));
+        }
+    }
+
+    NS_ASSERT (nextClientIndex == nEquipments); 
+
+    // Exécution distribuée : toutes les applications sont configurées partout (mêmes tirages des heures de début),
+    // mais chaque processus ne fait tourner et ne mesure que celles de ses propres nœuds
+    if (g_systemCount > 1)
+    {
+        for (uint32_t n = 0; n < NodeList::GetNNodes(); ++n)
+        {
+            Ptr<Node> node = NodeList::GetNode(n);
+            if (node->GetSystemId() == g_systemId)
+            {
+                continue;
+            }
+            for (uint32_t a = 0; a < node->GetNApplications(); ++a)
+            {
+                node->GetApplication(a)->SetStartTime(Seconds(2 * DUREE_SIMULATION));
+                node->GetApplication(a)->SetStopTime(Seconds(2 * DUREE_SIMULATION));
+            }
+            g_installedSinks.erase(node->GetId());
+        }
+    }
+
+    // --- 7. FlowMonitor  ---
+    FlowMonitorHelper flowmon;
+    Ptr<FlowMonitor> monitor;
+    if (outputs.enableFlowMonitor)
+    {
+        NS_LOG_INFO("Installation du FlowMonitor sur tous les nœuds");
+        monitor = flowmon.InstallAll();
+        // Récupérer le classifieur qui a été utilisé pour identifier les flux
+        Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+    }
+
+    // --- Séries temporelles (relevés périodiques par sink) ---
+    TimeSeriesSampler sampler;
+    if (outputs.sampleInterval > 0)
+    {
+        Ptr<Ipv4FlowClassifier> sampleClassifier = monitor ? DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier()) : 0;
+        sampler.Start(outputs.sampleInterval, DUREE_SIMULATION, outputs.sampleMaxRecords, monitor, sampleClassifier);
+    }
+
+    // --- Préchauffage et détection du régime stationnaire ---
+    if (config.warmup > 0)
+    {
+        Simulator::Schedule(Seconds(config.warmup), &StartMeasurement, monitor, outputs.sampleInterval > 0 ? &sampler : nullptr);
+    }
+    SteadyStateDetector steadyState;
+    if (config.steadyState)
+    {
+        steadyState.Start(config.warmup, config);
+    }
+
+    // --- 8. Collecte de Traces PCAP ---
+    // Par défaut toutes les interfaces de tous les nœuds (EnablePcapIpv4All) ; avec --pcapInterfaces,
+    // --pcapPorts, --pcapProtocol ou --pcapSnapLen, seules les interfaces et les paquets choisis sont écrits.
+    // Avec --asyncTraces, les écritures sont faites par un thread dédié (simulation-domestique-common/simulation-domestique-async-writer.h).
+    PcapCapture pcapCapture;
+    std::unique_ptr<AsyncTraceWriter> traceWriter;
+    bool selectivePcap = false;
+    if (outputs.enablePcap)
+    {
+        NS_ABORT_MSG_IF(outputs.pcapProtocol != "all" && outputs.pcapProtocol != "tcp" && outputs.pcapProtocol != "udp",
+                        "--pcapProtocol doit valoir all, tcp ou udp");
+        pcapCapture.portRanges = ParsePortRanges(outputs.pcapPorts);
+        pcapCapture.protocol = outputs.pcapProtocol == "tcp" ? 6 : (outputs.pcapProtocol == "udp" ? 17 : 0);
+        selectivePcap = outputs.pcapInterfaces != "all" || pcapCapture.Filtering() || outputs.pcapSnapLen > 0 || outputs.asyncTraces;
+        std::string prefix = OutputName("trace-ml-ip");
+        if (!selectivePcap)
+        {
+            NS_LOG_INFO("Activation de la capture PCAP sur toutes les interfaces : " << prefix << "-*");
+            stack.EnablePcapIpv4All(prefix);
+        }
+        else
+        {
+            pcapCapture.snapLen = outputs.pcapSnapLen > 0 ? outputs.pcapSnapLen : 65535;
+            if (outputs.asyncTraces)
+            {
+                traceWriter.reset(new AsyncTraceWriter((std::size_t)outputs.asyncBufferMb << 20));
+                pcapCapture.writer = traceWriter.get();
+            }
+            for (const std::string &item : SplitList(outputs.pcapInterfaces, ','))
+            {
+                if (item == "all")
+                {
+                    for (uint32_t n = 0; n < NodeList::GetNNodes(); ++n)
+                    {
+                        pcapCapture.AddNode(NodeList::GetNode(n), prefix);
+                    }
+                }
+                else if (item == "ap")
+                {
+                    // Interface Wi-Fi de chaque AP : tout le trafic des équipements y passe une seule fois
+                    for (uint32_t b = 0; b < nAps; ++b)
+                    {
+                        Ptr<Ipv4> apIpv4 = apNodes.Get(b)->GetObject<Ipv4>();
+                        pcapCapture.AddInterface(apNodes.Get(b), apIpv4->GetInterfaceForDevice(apDevices.Get(b)), prefix);
+                    }
+                }
+                else
+                {
+                    char *end = nullptr;
+                    unsigned long nodeId = std::strtoul(item.c_str(), &end, 10);
+                    NS_ABORT_MSG_IF(end == item.c_str() || (*end != '\0' && *end != ':') || nodeId >= NodeList::GetNNodes(),
+                                    "--pcapInterfaces : entrée invalide '" << item << "' (all, ap, nœud ou nœud:interface)");
+                    if (*end == ':')
+                    {
+                        const char *ifaceText = end + 1;
+                        unsigned long iface = std::strtoul(ifaceText, &end, 10);
+                        NS_ABORT_MSG_IF(end == ifaceText || *end != '\0', "--pcapInterfaces : interface invalide dans '" << item << "'");
+                        pcapCapture.AddInterface(NodeList::GetNode(nodeId), iface, prefix);
+                    }
+                    else
+                    {
+                        pcapCapture.AddNode(NodeList::GetNode(nodeId), prefix);
+                    }
+                }
+            }
+            NS_LOG_INFO("Capture PCAP sélective : " << pcapCapture.files.size() << " nœud(s), ports '" << outputs.pcapPorts
+                        << "', protocole " << outputs.pcapProtocol << ", snaplen " << pcapCapture.snapLen);
+        }
+    }
+
+    // --- Caractéristiques ML calculées pendant la simulation (sans passer par les traces pcap) ---
+    MlFeatureCollector mlCollector;
+    if (outputs.enableMlFeatures)
+    {
+        mlCollector.Install();
+    }
+
+    // Bilan de la phase de construction (nœuds, pile IP, routage, applications, traces)
+    double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+    uint64_t rssAfterKb = GetResidentMemoryKb();
+    uint32_t totalNodes = NodeList::GetNNodes();
+    double kbPerNode = rssAfterKb > rssBeforeKb ? (double)(rssAfterKb - rssBeforeKb) / totalNodes : 0.0;
+    std::cout << "Construction du scénario : " << nEquipments << " équipements, " << totalNodes << " nœuds en "
+              << std::fixed << std::setprecision(3) << setupSeconds << " s | Mémoire : "
+              << std::setprecision(1) << kbPerNode << " Ko/nœud (RSS " << rssBeforeKb << " -> " << rssAfterKb << " Ko)" << std::endl;
+
+    // --- 8. Lancement de la Simulation ---
+    Simulator::Stop (Seconds(DUREE_SIMULATION));
+    auto runStart = std::chrono::steady_clock::now();
+    Simulator::Run ();
+    g_measureEnd = Simulator::Now().GetSeconds();
+    g_runStats.setupSeconds = setupSeconds;
+    g_runStats.runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    g_runStats.events = Simulator::GetEventCount();
+    std::cout << "Simulation : " << g_runStats.events << " événements en " << std::fixed << std::setprecision(3) << g_runStats.runSeconds
+              << " s (" << std::setprecision(0) << (g_runStats.runSeconds > 0 ? g_runStats.events / g_runStats.runSeconds : 0.0) << " év/s)" << std::endl;
+    
+    if (cachedLoss)
+    {
+        const StaticLinkCache &lossCache = cachedLoss->GetCache();
+        const StaticLinkCache &delayCache = cachedDelay->GetCache();
+        std::cout << "Cache de propagation : pertes " << std::setprecision(1) << 100.0 * lossCache.HitRate() << " % de succès ("
+                  << lossCache.hits + lossCache.misses << " appels), délais " << 100.0 * delayCache.HitRate() << " % ("
+                  << delayCache.hits + delayCache.misses << " appels) | " << lossCache.indexes.size() << " nœuds, "
+                  << 2 * lossCache.values.size() * sizeof(double) / 1048576.0 << " Mo" << std::endl;
+    }
+    if (!cullingFilters.empty())
+    {
+        uint64_t checked = 0;
+        uint64_t culled = 0;
+        std::size_t links = 0;
+        for (const Ptr<ReceiverCullingFilter> &cullingFilter : cullingFilters)
+        {
+            checked += cullingFilter->GetChecked();
+            culled += cullingFilter->GetCulled();
+            links += cullingFilter->GetLinks();
+        }
+        std::ostringstream threshold;
+        if (std::isnan(config.cullThresholdDbm))
+        {
+            threshold << "la RxSensitivity des récepteurs";
+        }
+        else
+        {
+            threshold << config.cullThresholdDbm << " dBm";
+        }
+        std::cout << "Réceptions filtrées : " << culled << " sur " << checked << " (" << std::setprecision(1)
+                  << (checked > 0 ? 100.0 * culled / checked : 0.0) << " %) sous " << threshold.str()
+                  << " | " << links << " liens évalués" << std::endl;
+    }
+    if (config.steadyState && !steadyState.converged)
+    {
+        std::cout << "Régime stationnaire non atteint en " << steadyState.batches << " lots : simulation menée jusqu'à " << g_measureEnd << " s" << std::endl;
+    }
+    if (selectivePcap)
+    {
+        std::cout << "Capture PCAP : " << pcapCapture.written << " paquets écrits, " << pcapCapture.filtered << " écartés par le filtre" << std::endl;
+    }
+    if (traceWriter)
+    {
+        // Attend que le thread d'écriture ait tout vidé ; les attentes mesurent la contre-pression subie par le simulateur
+        traceWriter->Close();
+        AsyncWriterStats writerStats = traceWriter->GetStats();
+        std::cout << "Écriture asynchrone : " << writerStats.records << " enregistrements (" << std::setprecision(1)
+                  << writerStats.bytes / 1048576.0 << " Mo) en " << writerStats.batches << " lots | tampon plein : "
+                  << writerStats.stalls << " attentes (" << std::setprecision(3) << writerStats.stallSeconds << " s) | remplissage max "
+                  << std::setprecision(1) << 100.0 * writerStats.maxFill / traceWriter->Capacity() << " %" << std::endl;
+    }
+    if (outputs.sampleInterval > 0)
+    {
+        sampler.Flush();
+        uint64_t overwritten = sampler.Write(OutputName(outputs.sampleOutput));
+        std::cout << "Séries temporelles : " << std::min<uint64_t>(sampler.recorded, sampler.ring.size()) << " relevés dans "
+                  << OutputName(outputs.sampleOutput);
+        if (overwritten > 0)
+        {
+            std::cout << " (" << overwritten << " plus anciens écrasés, augmenter --sampleMaxRecords)";
+        }
+        std::cout << std::endl;
+    }
+    if (outputs.enableMlFeatures)
     {
-        wifiHelper.SetStandard(WIFI_STANDARD_80211ac);
-        NS_LOG_INFO("J'impose le standard Wi‑Fi : 802.11ac");
+        uint64_t rows = mlCollector.Write(OutputName(outputs.mlOutput));
+        std::cout << "Dataset ML : " << rows << " chunks écrits dans " << OutputName(outputs.mlOutput) << std::endl;
     }
-    else
+    
+    // --- Optionnel : sérialisation du FlowMonitor ---
+    // En format binaire, les statistiques par flux sont écrites par CalculateMetrics dans le fichier en colonnes
+    if (outputs.enableFlowMonitor)
     {
-        NS_LOG_INFO("Utilisation du standard Wi‑Fi par défaut (sans contrainte). ");
+        if (monitor)
+        {
+            monitor->CheckForLostPackets();
+            if (!outputs.BinaryMetrics())
+            {
+                flowmon.SerializeToXmlFile(OutputName(outputs.flowOutput), true, true);
+                NS_LOG_INFO("FlowMonitor enregistré dans " << OutputName(outputs.flowOutput));
+            }
+        }
+        else
+        {
+            NS_LOG_WARN("FlowMonitor activé mais le pointeur 'monitor' est nul");
+        }
     }
 
-    
-    // Utilisation de Minstrel HT manager pour les modes haut débit (supporte HT/VHT)
-    wifiHelper.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
+    // --- 9. Post-traitement et Extraction de Métriques ---
+        // J'appele le calcul des métriques en transmettant le monitor et le classifier 
+        Ptr<Ipv4FlowClassifier> classifierPtr = 0;
+        if (outputs.enableFlowMonitor) {
+            classifierPtr = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+        }
+        CalculateMetrics(monitor, classifierPtr, outputs);
+}
 
-    
-    WifiMacHelper macHelper;
-    Ssid ssid = Ssid("MaisonConnectee");
 
-    // a) Configuration AP
-    macHelper.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
-    NetDeviceContainer apDevice = wifiHelper.Install(phyHelper, macHelper, apNode);
+// --- Réplications indépendantes en parallèle ---
+// Chaque réplication tourne dans un processus fils (fork) : l'état global du scénario (g_installedSinks,
+// g_trafficSources, debutAleatoire) et le Simulator sont ainsi propres à chaque RngRun.
 
-    // b) Configuration Clients
-    macHelper.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
-    NetDeviceContainer clientDevices = wifiHelper.Install(phyHelper, macHelper, clientNodes);
+/**
+ * @brief Exécute count tâches dans des processus fils, au plus jobs simultanément.
+ * child(i) est appelé dans le fils (son code de retour devient le statut du processus) ;
+ * onDone(i, ok) est appelé dans le parent à la fin de chaque tâche et renvoie false pour ne plus en lancer.
+ * @return Le nombre de tâches terminées avec succès.
+ */
+uint32_t RunInWorkers(uint32_t count, uint32_t jobs, const std::function<int(uint32_t)> &child, const std::function<bool(uint32_t, bool)> &onDone)
+{
+    if (jobs == 0)
+    {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::map<pid_t, uint32_t> running;
+    uint32_t next = 0;
+    uint32_t succeeded = 0;
+    bool launchMore = true;
 
-    // Diagnostic : affichage de la configuration (le reste est inchangé)
-    Ptr<WifiNetDevice> apWifiDev = DynamicCast<WifiNetDevice>(apDevice.Get(0));
-    if (apWifiDev)
+    while (!running.empty() || (launchMore && next < count))
     {
-            NS_LOG_INFO("Type de WifiNetDevice AP : " << apWifiDev->GetInstanceTypeId().GetName());
-        Ptr<WifiPhy> apPhy = apWifiDev->GetPhy();
-        if (apPhy)
-        {
-            NS_LOG_INFO("Type Phy AP : " << apPhy->GetInstanceTypeId().GetName());
-            NS_LOG_INFO("Standard Phy AP configuré : " << apPhy->GetStandard());
-            NS_LOG_INFO("Bande Phy AP : " << apPhy->GetPhyBand());
-        }
-        Ptr<WifiRemoteStationManager> apRsm = apWifiDev->GetRemoteStationManager();
-        if (apRsm)
+        while (launchMore && next < count && running.size() < jobs)
         {
-            NS_LOG_INFO("RemoteStationManager AP : " << apRsm->GetInstanceTypeId().GetName());
+            // Vider les tampons avant fork, sinon le fils réécrit la sortie déjà en attente du parent
+            std::cout.flush();
+            std::cerr.flush();
+            pid_t pid = fork();
+            NS_ABORT_MSG_IF(pid < 0, "fork() a échoué pour la tâche " << next);
+            if (pid == 0)
+            {
+                int status = child(next);
+                std::cout.flush();
+                std::cerr.flush();
+                _exit(status);
+            }
+            running[pid] = next++;
         }
-    }
-    Ptr<WifiNetDevice> staWifiDev = DynamicCast<WifiNetDevice>(clientDevices.Get(0));
-    if (staWifiDev)
-    {
-        NS_LOG_INFO("Type de WifiNetDevice STA : " << staWifiDev->GetInstanceTypeId().GetName());
-        Ptr<WifiPhy> staPhy = staWifiDev->GetPhy();
-        if (staPhy)
+
+        int status = 0;
+        pid_t done = waitpid(-1, &status, 0);
+        if (done < 0)
         {
-            NS_LOG_INFO("Type Phy STA : " << staPhy->GetInstanceTypeId().GetName());
-            NS_LOG_INFO("Standard Phy STA configuré : " << staPhy->GetStandard());
-            NS_LOG_INFO("Bande Phy STA : " << staPhy->GetPhyBand());
+            NS_LOG_WARN("waitpid() a échoué : " << std::strerror(errno));
+            break;
         }
-        Ptr<WifiRemoteStationManager> staRsm = staWifiDev->GetRemoteStationManager();
-        if (staRsm)
+        auto it = running.find(done);
+        if (it == running.end())
         {
-            NS_LOG_INFO("RemoteStationManager STA : " << staRsm->GetInstanceTypeId().GetName());
+            continue;
         }
+        uint32_t index = it->second;
+        running.erase(it);
+        bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        succeeded += ok ? 1 : 0;
+        launchMore = onDone(index, ok) && launchMore;
     }
-    
-    // --- 4. Configuration Réseau Serveurs (Ethernet) ---
-    PointToPointHelper p2pHelper;
-    p2pHelper.SetDeviceAttribute("DataRate", StringValue("1000Mbps"));
-    p2pHelper.SetChannelAttribute("Delay", StringValue("1ms"));
-    
-    NetDeviceContainer apP2pDevices;
-    NetDeviceContainer serverDevices;
-    std::vector<NetDeviceContainer> p2pLinks;
+    return succeeded;
+}
 
-    
-    Ipv4AddressHelper p2pAddress;
-    p2pAddress.SetBase("10.2.1.0", "255.255.255.0");
-    
-    for (uint32_t i = 0; i < K_TYPES; ++i)
+// Métriques d'une application (port) agrégées sur les réplications
+struct PortReplicationStats
+{
+    std::string appType;
+    RunningStat throughputMbps;
+    RunningStat lossPct;
+    RunningStat meanDelayMs;
+    RunningStat meanJitterMs;
+};
+
+/**
+ * @brief Lit le résumé CSV d'une réplication, recopie ses lignes (préfixées du run) dans merged
+ * et ajoute une observation par port : débit total, perte globale, délai et gigue moyens pondérés par rxPackets.
+ * @return false si le fichier est absent.
+ */
+bool AddSummaryReplication(const std::string &summaryName, uint64_t run, std::map<uint16_t, PortReplicationStats> &stats, std::ostream &merged)
+{
+    std::ifstream in(summaryName);
+    if (!in.is_open())
     {
-        NetDeviceContainer link = p2pHelper.Install(apNode, serverNodes.Get(i));
-        apP2pDevices.Add(link.Get(0));
-        serverDevices.Add(link.Get(1));
-        p2pLinks.push_back(link);
+        return false;
     }
+    struct PortTotals { std::string appType; uint64_t tx = 0, rx = 0; double throughput = 0.0, delayWeighted = 0.0, jitterWeighted = 0.0; };
+    std::map<uint16_t, PortTotals> totals;
+    std::string line;
+    std::getline(in, line); // en-tête
+    while (std::getline(in, line))
+    {
+        if (line.empty()) continue;
+        merged << run << "," << line << "\n";
+        // nodeId,port,appType,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs
+        std::vector<std::string> f;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) f.push_back(field);
+        if (f.size() < 12) continue;
+        PortTotals &t = totals[(uint16_t)std::stoul(f[1])];
+        t.appType = f[2];
+        uint64_t rx = std::stoull(f[4]);
+        t.tx += std::stoull(f[3]);
+        t.rx += rx;
+        t.throughput += std::stod(f[9]);
+        t.delayWeighted += std::stod(f[10]) * rx;
+        t.jitterWeighted += std::stod(f[11]) * rx;
+    }
+    for (const auto &kv : totals)
+    {
+        const PortTotals &t = kv.second;
+        PortReplicationStats &p = stats[kv.first];
+        p.appType = t.appType;
+        p.throughputMbps.Add(t.throughput);
+        p.lossPct.Add(LossPercent(t.tx, t.rx));
+        p.meanDelayMs.Add(t.rx > 0 ? t.delayWeighted / t.rx : 0.0);
+        p.meanJitterMs.Add(t.rx > 0 ? t.jitterWeighted / t.rx : 0.0);
+    }
+    return true;
+}
 
-    // --- 5. Installation de la Pile Internet (IP) ---
-    InternetStackHelper stack;
-    stack.Install(apNode);
-    stack.Install(clientNodes);
-    stack.Install(serverNodes);
-
-    // Adressage stratégique : 10.1.1.0/24
-    Ipv4AddressHelper address; 
-    address.SetBase ("10.1.1.0", "255.255.255.0"); 
-    
-    // Attribution des adresses IP aux interfaces
-    address.Assign(apDevice);
-    address.Assign(clientDevices);
+// Écrit moyenne, écart-type et IC à 95 % par port et par métrique
+void WriteReplicationCi(const std::string &filename, const std::map<uint16_t, PortReplicationStats> &stats)
+{
+    std::ofstream out(filename);
+    out << "port,appType,metric,replications,mean,stdev,ci95HalfWidth,ci95Low,ci95High\n";
+    for (const auto &kv : stats)
+    {
+        const PortReplicationStats &p = kv.second;
+        const std::pair<const char *, const RunningStat *> metrics[] = {
+            {"throughputMbps", &p.throughputMbps}, {"lossPct", &p.lossPct},
+            {"meanDelayMs", &p.meanDelayMs}, {"meanJitterMs", &p.meanJitterMs}};
+        for (const auto &m : metrics)
+        {
+            double hw = m.second->HalfWidth();
+            out << kv.first << "," << p.appType << "," << m.first << "," << m.second->n << ","
+                << m.second->mean << "," << m.second->Stdev() << "," << hw << ","
+                << m.second->mean - hw << "," << m.second->mean + hw << "\n";
+        }
+    }
+}
 
-    // Assigner des adresses IP à chaque lien point-à-point créé plus tôt
-    for (auto &link : p2pLinks)
+/**
+ * @brief Plus grande demi-largeur relative de l'IC à 95 % parmi tous les ports et métriques.
+ * Une métrique de moyenne nulle et d'IC nul (ex. aucune perte) est considérée comme convergée.
+ * @param worst reçoit "port/métrique" de la plus mauvaise.
+ * @return +infini si une métrique a moins de minReplications observations.
+ */
+double WorstRelativeHalfWidth(const std::map<uint16_t, PortReplicationStats> &stats, uint32_t minReplications, std::string &worst)
+{
+    double result = stats.empty() ? INFINITY : 0.0;
+    for (const auto &kv : stats)
     {
-        p2pAddress.Assign(link);
-        p2pAddress.NewNetwork();
+        const PortReplicationStats &p = kv.second;
+        const std::pair<const char *, const RunningStat *> metrics[] = {
+            {"throughputMbps", &p.throughputMbps}, {"lossPct", &p.lossPct},
+            {"meanDelayMs", &p.meanDelayMs}, {"meanJitterMs", &p.meanJitterMs}};
+        for (const auto &m : metrics)
+        {
+            double hw = m.second->HalfWidth();
+            double relative = m.second->n < minReplications ? INFINITY
+                              : (hw == 0.0 ? 0.0 : hw / std::fabs(m.second->mean));
+            if (relative > result || worst.empty())
+            {
+                result = std::max(result, relative);
+                worst = std::to_string(kv.first) + "/" + m.first;
+            }
+        }
     }
-    
+    return result;
+}
 
-    // Remplissage des tables de routage globales pour permettre le routage entre AP et liens point-à-point
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
-    
-    // Débogage : j'affiche les adresses IP 
-    NS_LOG_INFO ("Adresses assignées pour les serveurs et clients :");
-    for (uint32_t i = 0; i < serverNodes.GetN (); ++i)
+/**
+ * @brief Lance jusqu'à replications exécutions indépendantes (RngRun = firstRun, firstRun + 1, ...) sur jobs processus,
+ * puis fusionne leurs résumés summary-runN-<csvOutput> dans replications-<csvOutput>
+ * et écrit les intervalles de confiance par port dans ci-<csvOutput>.
+ * Si ciTarget > 0, les moyennes et variances sont mises à jour à la fin de chaque réplication et aucune nouvelle
+ * réplication n'est lancée dès que toutes les métriques (au moins minReplications observations) ont une
+ * demi-largeur relative d'IC sous ciTarget ; les réplications déjà en cours sont menées à terme et comptées.
+ */
+void RunReplications(const std::function<void()> &runOnce, const std::string &csvOutput, uint32_t replications, uint32_t jobs, uint64_t firstRun,
+                     double ciTarget, uint32_t minReplications)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto runName = [firstRun](uint32_t i) { return "run" + std::to_string(firstRun + i) + "-"; };
+
+    auto child = [&](uint32_t i) {
+        RngSeedManager::SetRun(firstRun + i);
+        g_outputPrefix = runName(i);
+        // La console de chaque réplication est redirigée vers son propre journal
+        std::string logName = OutputName("simulation-domestique.log");
+        if (!std::freopen(logName.c_str(), "w", stdout) || !std::freopen(logName.c_str(), "a", stderr))
+        {
+            return 1;
+        }
+        InitDebutAleatoire();
+        runOnce();
+        Simulator::Destroy();
+        return 0;
+    };
+
+    // Chaque résumé est lu dès la fin de sa réplication ; ses lignes sont gardées par run pour être fusionnées dans l'ordre
+    std::map<uint16_t, PortReplicationStats> stats;
+    std::map<uint32_t, std::string> mergedLines;
+    bool converged = false;
+    auto onDone = [&](uint32_t i, bool ok) {
+        std::cout << "Réplication RngRun=" << firstRun + i << (ok ? " terminée" : " en échec");
+        std::string summaryName = "summary-" + runName(i) + csvOutput;
+        std::ostringstream lines;
+        if (ok && AddSummaryReplication(summaryName, firstRun + i, stats, lines))
+        {
+            mergedLines[i] = lines.str();
+        }
+        else if (ok)
+        {
+            NS_LOG_WARN("Résumé absent pour la réplication " << firstRun + i << " : " << summaryName);
+        }
+        if (ciTarget > 0 && !converged)
+        {
+            std::string worst;
+            double relative = WorstRelativeHalfWidth(stats, minReplications, worst);
+            if (std::isfinite(relative))
+            {
+                std::cout << " | demi-largeur relative max " << std::fixed << std::setprecision(1) << relative * 100.0 << " % (" << worst << ")";
+            }
+            converged = relative <= ciTarget;
+            if (converged)
+            {
+                std::cout << " | IC sous " << ciTarget * 100.0 << " % : plus de nouvelle réplication";
+            }
+        }
+        std::cout << std::endl;
+        return !converged;
+    };
+    uint32_t succeeded = RunInWorkers(replications, jobs, child, onDone);
+
+    std::ofstream merged("replications-" + csvOutput);
+    merged << "run,nodeId,port,appType,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs\n";
+    for (const auto &kv : mergedLines)
     {
-        Ptr<Node> node = serverNodes.Get (i);
-        Ipv4Address addr = GetFirstIpv4Address(node);
-        NS_LOG_INFO ("Serveur " << i << " -> " << addr);
+        merged << kv.second;
     }
-    for (uint32_t i = 0; i < clientNodes.GetN (); ++i)
+    merged.close();
+    WriteReplicationCi("ci-" + csvOutput, stats);
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << succeeded << "/" << replications << " réplications terminées en " << std::fixed << std::setprecision(1) << wall
+              << " s | Lignes fusionnées : replications-" << csvOutput << " | IC 95 % : ci-" << csvOutput << std::endl;
+    if (ciTarget > 0 && !converged)
     {
-        Ptr<Node> node = clientNodes.Get (i);
-        Ipv4Address addr = GetFirstIpv4Address(node);
-        NS_LOG_INFO ("Client " << i << " -> " << addr);
+        NS_LOG_WARN("Objectif d'IC (" << ciTarget * 100.0 << " %) non atteint en " << replications << " réplications");
     }
-    
+}
 
-    // --- 6. Déploiement des Applications ---
-    uint32_t nextClientIndex = 0; 
-    
-    // Configuration de chaque type d'application (clients N_EQUIPMENTS = 32)
-    for (uint32_t i = 0; i < 5; ++i) { ConfigureCamera(clientNodes.Get(nextClientIndex++), serverNodes.Get(0), debutAleatoire->GetValue()); } // 5 caméras
-    for (uint32_t i = 0; i < 10; ++i) { ConfigureSensor(clientNodes.Get(nextClientIndex++), serverNodes.Get(1), debutAleatoire->GetValue()); } // 10 capteurs
-    for (uint32_t i = 0; i < 3; ++i) { ConfigureVoiceAssistant(clientNodes.Get(nextClientIndex++), serverNodes.Get(2), debutAleatoire->GetValue()); } // 3 assistants vocaux
-    for (uint32_t i = 0; i < 2; ++i) { ConfigureDownload(clientNodes.Get(nextClientIndex++), serverNodes.Get(3), debutAleatoire->GetValue()); } // 2 téléchargements
-    for (uint32_t i = 0; i < 4; ++i) { ConfigureVoIP(clientNodes.Get(nextClientIndex++), serverNodes.Get(4), debutAleatoire->GetValue()); } // 4 sessions VoIP
-    for (uint32_t i = 0; i < 4; ++i) { ConfigureDomotics(clientNodes.Get(nextClientIndex++), serverNodes.Get(5), debutAleatoire->GetValue()); } // 4 domotiques
-    ConfigureStreaming(clientNodes.Get(nextClientIndex++), serverNodes.Get(6), debutAleatoire->GetValue()); // 1 streaming
-    ConfigureDoorbell(clientNodes.Get(nextClientIndex++), serverNodes.Get(7), debutAleatoire->GetValue()); // 1 sonnette
-    ConfigureFirmwareUpdate(clientNodes.Get(nextClientIndex++), serverNodes.Get(8), debutAleatoire->GetValue()); // 1 màj
-    ConfigureMonitoring(clientNodes.Get(nextClientIndex++), serverNodes.Get(9), debutAleatoire->GetValue()); // 1 monitoring
-
-    NS_ASSERT (nextClientIndex == N_EQUIPMENTS); 
 
-    // --- 7. FlowMonitor  ---
-    FlowMonitorHelper flowmon;
-    Ptr<FlowMonitor> monitor;
-    if (enableFlowMonitor)
+// --- Balayage de paramètres avec cache de résultats ---
+// Chaque point (configuration + RngSeed + RngRun) est identifié par le hachage de sa représentation canonique.
+// Le magasin de résultats (un répertoire) contient pour chaque point déjà simulé :
+//   <clé>.cfg                  : la représentation canonique du point, puis "setupSeconds,runSeconds,events"
+//   summary-<clé>-metrics.csv  : le résumé par application de cette exécution
+// Les points présents sont réutilisés, les autres sont simulés en parallèle (RunInWorkers), puis
+// l'ensemble est rassemblé dans une seule table (une ligne par point et par sink).
+
+// Hachage FNV-1a 64 bits (stable entre plateformes et versions, contrairement à std::hash)
+uint64_t HashFnv1a(const std::string &text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text)
     {
-        NS_LOG_INFO("Installation du FlowMonitor sur tous les nœuds");
-        monitor = flowmon.InstallAll();
-        // Récupérer le classifieur qui a été utilisé pour identifier les flux
-        Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+        hash ^= c;
+        hash *= 1099511628211ULL;
     }
+    return hash;
+}
 
-    // --- 8. Collecte de Traces PCAP ---
-    if (enablePcap)
+struct SweepPoint
+{
+    ScenarioConfig config;
+    uint64_t run;
+    std::string canonical;   // configuration, graine et run : clé du cache
+    std::string key;
+};
+
+/**
+ * @brief Simule les points absents du magasin store (au plus jobs processus), puis écrit la table output.
+ * Colonnes : clé et paramètres du point, coût de l'exécution, puis les colonnes du résumé par application.
+ */
+void RunSweep(const std::vector<ScenarioConfig> &configs, uint32_t seeds, uint64_t firstRun, const std::string &store, const std::string &output, uint32_t jobs)
+{
+    const std::string csvName = "metrics.csv";
+    NS_ABORT_MSG_IF(mkdir(store.c_str(), 0755) != 0 && errno != EEXIST, "Impossible de créer le magasin de résultats " << store);
+
+    // Les processus fils héritent de la graine (--RngSeed) : elle fait partie de la clé comme le run
+    uint32_t rngSeed = RngSeedManager::GetSeed();
+    std::vector<SweepPoint> points;
+    std::vector<uint32_t> pending;
+    for (const ScenarioConfig &config : configs)
     {
-        NS_LOG_INFO("Activation de la capture PCAP : traces-simulation-domestique*");
-        // Capturer uniquement sur l'interface AP pour réduire la taille des traces
-        NS_LOG_INFO("Activation PCAP uniquement sur l'interface AP (traces-simulation-domestique-ap)");
-        if (apDevice.GetN() > 0) {
-            stack.EnablePcapIpv4All("trace-ml-ip");
-        } else {
-            NS_LOG_WARN("Pas d'interface AP trouvée pour la capture PCAP.");
+        for (uint32_t seed = 0; seed < seeds; ++seed)
+        {
+            SweepPoint point{config, firstRun + seed, "", ""};
+            point.canonical = config.Canonical() + ";seed=" + std::to_string(rngSeed) + ";run=" + std::to_string(point.run);
+            std::ostringstream key;
+            key << std::hex << std::setw(16) << std::setfill('0') << HashFnv1a(point.canonical);
+            point.key = key.str();
+            std::ifstream cached(store + "/" + point.key + ".cfg");
+            std::string cachedCanonical;
+            if (!(cached.is_open() && std::getline(cached, cachedCanonical) && cachedCanonical == point.canonical))
+            {
+                pending.push_back(points.size());
+            }
+            points.push_back(point);
         }
     }
+    std::cout << "Balayage : " << points.size() << " points, " << points.size() - pending.size() << " déjà dans " << store
+              << ", " << pending.size() << " à simuler" << std::endl;
 
-    // --- 8. Lancement de la Simulation ---
-    Simulator::Stop (Seconds(DUREE_SIMULATION));
-    Simulator::Run ();
-    
-    // --- Optionnel : sérialisation du FlowMonitor ---
-    if (enableFlowMonitor)
+    auto child = [&](uint32_t i) {
+        const SweepPoint &point = points[pending[i]];
+        if (chdir(store.c_str()) != 0)
+        {
+            return 1;
+        }
+        RngSeedManager::SetRun(point.run);
+        g_outputPrefix = point.key + "-";
+        std::string logName = OutputName("simulation-domestique.log");
+        if (!std::freopen(logName.c_str(), "w", stdout) || !std::freopen(logName.c_str(), "a", stderr))
+        {
+            return 1;
+        }
+        InitDebutAleatoire();
+        // Format binaire : la table s'appuie sur le résumé CSV, le XML de FlowMonitor serait inutile et volumineux
+        OutputOptions outputs;
+        outputs.enableFlowMonitor = true;
+        outputs.enableCsv = true;
+        outputs.csvOutput = csvName;
+        outputs.metricsFormat = "binary";
+        RunSimulation(point.config, outputs);
+        Simulator::Destroy();
+        // Le .cfg n'est écrit qu'en fin d'exécution réussie : c'est lui qui valide l'entrée du cache
+        std::ofstream cfg(point.key + ".cfg");
+        cfg << point.canonical << "\n"
+            << g_runStats.setupSeconds << "," << g_runStats.runSeconds << "," << g_runStats.events << "\n";
+        return cfg.good() ? 0 : 1;
+    };
+    auto onDone = [&](uint32_t i, bool ok) {
+        const SweepPoint &point = points[pending[i]];
+        std::cout << "Point " << point.key << " (" << point.canonical << ")"
+                  << (ok ? " simulé" : " en échec") << std::endl;
+        return true;
+    };
+    RunInWorkers(pending.size(), jobs, child, onDone);
+
+    std::ofstream table(output);
+    table << "key,run,duration,forceAc,mix,rateManager,aps,channelModel,wifiChannels,setupSeconds,runSeconds,events,"
+          << "nodeId,port,appType,txPackets,rxPackets,lostPackets,lossPct,txBytes,rxBytes,throughputMbps,meanDelayMs,meanJitterMs\n";
+    uint32_t rows = 0;
+    for (const SweepPoint &point : points)
     {
-        if (monitor)
+        std::ifstream cfg(store + "/" + point.key + ".cfg");
+        std::ifstream summary(store + "/summary-" + point.key + "-" + csvName);
+        std::string canonical, cost, line;
+        if (!std::getline(cfg, canonical) || !std::getline(cfg, cost) || !std::getline(summary, line))
         {
-            monitor->CheckForLostPackets();
-            flowmon.SerializeToXmlFile(flowOutput, true, true);
-            NS_LOG_INFO("FlowMonitor enregistré dans " << flowOutput);
+            NS_LOG_WARN("Résultat manquant pour le point " << point.key);
+            continue;
         }
-        else
+        std::ostringstream prefix;
+        prefix << point.key << "," << point.run << "," << point.config.duration << "," << (point.config.forceAc ? 1 : 0) << ",\"";
+        for (uint32_t i = 0; i < point.config.mix.counts.size(); ++i)
         {
-            NS_LOG_WARN("FlowMonitor activé mais le pointeur 'monitor' est nul");
+            prefix << (i ? "," : "") << point.config.mix.counts[i];
         }
-    }
-
-    // --- 9. Post-traitement et Extraction de Métriques ---
-        // J'appele le calcul des métriques en transmettant le monitor et le classifier 
-        Ptr<Ipv4FlowClassifier> classifierPtr = 0;
-        if (enableFlowMonitor) {
-            classifierPtr = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+        prefix << "\"," << point.config.rateManager << "," << point.config.aps << "," << point.config.channelModel << ","
+               << point.config.wifiChannels << "," << cost << ",";
+        while (std::getline(summary, line))
+        {
+            if (line.empty()) continue;
+            table << prefix.str() << line << "\n";
+            ++rows;
         }
-        CalculateMetrics(monitor, classifierPtr, enableCsv, csvOutput);
+    }
+    std::cout << "Table de résultats : " << output << " (" << rows << " lignes)" << std::endl;
 }
 
+#ifdef NS3_MPI
+/**
+ * @brief Rassemble sur le processus 0 le coût de chaque processus d'une exécution distribuée et affiche
+ * le déséquilibre de charge ; si sequentialSeconds (durée de Simulator::Run du même scénario en un seul
+ * processus) est connue, affiche aussi l'accélération et le surcoût de synchronisation.
+ */
+void ReportDistributedRun(double sequentialSeconds)
+{
+    double local[3] = {(double)g_runStats.events, g_runStats.runSeconds, g_runStats.setupSeconds};
+    std::vector<double> all(3 * g_systemCount);
+    MPI_Gather(local, 3, MPI_DOUBLE, all.data(), 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (g_systemId != 0)
+    {
+        return;
+    }
+
+    double totalEvents = 0.0;
+    double maxEvents = 0.0;
+    double maxRunSeconds = 0.0;
+    for (uint32_t r = 0; r < g_systemCount; ++r)
+    {
+        double events = all[3 * r];
+        double runSeconds = all[3 * r + 1];
+        std::cout << "Processus " << r << " : " << std::fixed << std::setprecision(0) << events << " événements en "
+                  << std::setprecision(3) << runSeconds << " s (" << std::setprecision(0) << (runSeconds > 0 ? events / runSeconds : 0.0)
+                  << " év/s), construction " << std::setprecision(3) << all[3 * r + 2] << " s" << std::endl;
+        totalEvents += events;
+        maxEvents = std::max(maxEvents, events);
+        maxRunSeconds = std::max(maxRunSeconds, runSeconds);
+    }
+    std::cout << "Exécution distribuée : " << g_systemCount << " processus, " << std::setprecision(0) << totalEvents << " événements en "
+              << std::setprecision(3) << maxRunSeconds << " s (" << std::setprecision(0) << (maxRunSeconds > 0 ? totalEvents / maxRunSeconds : 0.0)
+              << " év/s) | déséquilibre (max / moyenne des événements) " << std::setprecision(2) << maxEvents * g_systemCount / totalEvents << std::endl;
+    if (sequentialSeconds > 0 && maxRunSeconds > 0)
+    {
+        // Temps au-delà d'un partage parfait du temps séquentiel : attentes de synchronisation et déséquilibre
+        double speedup = sequentialSeconds / maxRunSeconds;
+        double overhead = std::max(0.0, maxRunSeconds - sequentialSeconds / g_systemCount);
+        std::cout << "Accélération " << speedup << " (efficacité " << std::setprecision(1) << 100.0 * speedup / g_systemCount
+                  << " %) | surcoût de synchronisation et de déséquilibre " << std::setprecision(3) << overhead << " s ("
+                  << std::setprecision(1) << 100.0 * overhead / maxRunSeconds << " % du temps d'exécution)" << std::endl;
+    }
+}
+#endif
 
 // --- Le point d'entrée du programme C++ ---
+// Enregistre les opérations de l'ordonnanceur en vigueur (--SchedulerType, MapScheduler par défaut) dans la trace
+void InstallSchedulerRecorder(const OutputOptions &outputs)
+{
+    TypeIdValue schedulerType;
+    GlobalValue::GetValueByName("SchedulerType", schedulerType);
+    ObjectFactory factory("ns3::RecordingScheduler");
+    factory.Set("Scheduler", StringValue(schedulerType.Get().GetName()));
+    factory.Set("TraceFile", StringValue(OutputName(outputs.schedulerTrace)));
+    Simulator::SetScheduler(factory);
+}
+
+// Taille de la trace, une fois fermée par Simulator::Destroy
+void ReportSchedulerTrace(const OutputOptions &outputs)
+{
+    struct stat info;
+    if (stat(OutputName(outputs.schedulerTrace).c_str(), &info) == 0)
+    {
+        std::cout << "Trace de l'ordonnanceur : " << OutputName(outputs.schedulerTrace) << ", " << std::setprecision(1)
+                  << info.st_size / 1048576.0 << " Mo (" << (g_runStats.events > 0 ? (double)info.st_size / g_runStats.events : 0.0)
+                  << " octets par événement exécuté)" << std::endl;
+    }
+}
+
 int main (int argc, char *argv[])
 {
     // LogLevel INFO pour la phase de configuration
     LogComponentEnable("SimulationDomestique", LOG_LEVEL_INFO);
 
-    // Initialisation du générateur aléatoire
-    debutAleatoire->SetAttribute("Min", DoubleValue(0.0));
-    debutAleatoire->SetAttribute("Max", DoubleValue(5.0)); // Aléa [0, 5] secondes
-
     // Désactive les avertissements de la table de routage 
     LogComponentEnable("Ipv4GlobalRouting", LOG_LEVEL_WARN);
 
     // Paramètres CLI
     bool forceAc = true;
-    bool enableFlowMonitor = false;
-    std::string flowOutput = "traces_de_simulation.xml";
+    OutputOptions outputs;
     // Options de controle de la duree de simulation ,  capture PCAP et CSV
-    bool enablePcap = false; 
     double duration = DUREE_SIMULATION;
-    bool enableCsv = false;
-    std::string csvOutput = "simulation-domestique-metrics.csv";
+    // Description du foyer (par défaut la maison de référence de 32 équipements)
+    std::string mixSpec = "";
+    std::string mixFile = "";
+    uint32_t mixScale = 1;
+    // Profils d'application ajoutés à la table intégrée (simulation-domestique-profiles.h)
+    std::string profilesFile = "";
+    // Export de la table des profils en vigueur (default_profiles.txt des scripts Python), puis fin du programme
+    std::string exportProfiles = "";
+    // Mode réplications : nombre d'exécutions indépendantes et nombre de processus simultanés (0 = tous les cœurs)
+    uint32_t replications = 0;
+    uint32_t jobs = 0;
+    // Arrêt séquentiel : demi-largeur relative visée des IC à 95 % (0 = nombre fixe de réplications)
+    double ciTarget = 0.0;
+    uint32_t minReplications = 5;
+    std::string rateManager = "ns3::MinstrelHtWifiManager";
+    // Préchauffage et régime stationnaire (valeurs par défaut de ScenarioConfig)
+    ScenarioConfig defaults;
+    uint32_t aps = defaults.aps;
+    uint32_t floors = defaults.floors;
+    double roomSize = defaults.roomSize;
+    double floorHeight = defaults.floorHeight;
+    std::string channelModel = defaults.channelModel;
+    uint32_t wifiChannels = defaults.wifiChannels;
+    uint16_t wifiChannelWidth = defaults.wifiChannelWidth;
+    bool rxCulling = defaults.rxCulling;
+    double cullThresholdDbm = defaults.cullThresholdDbm;
+    bool propagationCache = defaults.propagationCache;
+    double warmup = defaults.warmup;
+    bool steadyState = defaults.steadyState;
+    double steadyBatch = defaults.steadyBatch;
+    double steadyTolerance = defaults.steadyTolerance;
+    uint32_t steadyMinBatches = defaults.steadyMinBatches;
+    // Exécution distribuée (ns-3 compilé avec MPI) : un BSS par processus à tour de rôle, synchronisation
+    // par messages nuls ("null") ou par fenêtres de temps accordé ("granted") ; durée séquentielle de référence
+    bool mpi = false;
+    std::string mpiSync = "null";
+    double sequentialRunSeconds = 0.0;
+    // Exécution multithread (ns-3 compilé avec MTP) : logements isolés, répartis sur mtpThreads threads (0 = tous les cœurs)
+    bool mtp = false;
+    uint32_t mtpThreads = 0;
+    bool isolatedHomes = defaults.isolatedHomes;
+    bool fixedStreams = defaults.fixedStreams;
+    // Balayage de paramètres : listes de valeurs séparées par '|' (vides = valeur courante)
+    bool sweep = false;
+    std::string sweepDuration = "";
+    std::string sweepForceAc = "";
+    std::string sweepMix = "";
+    std::string sweepRateManager = "";
+    std::string sweepAps = "";
+    std::string sweepChannelModel = "";
+    std::string sweepWifiChannels = "";
+    uint32_t sweepSeeds = 1;
+    std::string sweepStore = "sweep-store";
+    std::string sweepOutput = "sweep-results.csv";
 
     CommandLine cmd;
     cmd.AddValue("forceAc", "Force Wi-Fi standard to 802.11ac", forceAc);
-    cmd.AddValue("enableFlowMonitor", "Enable FlowMonitor and write XML", enableFlowMonitor);
-    cmd.AddValue("flowOutput", "FlowMonitor output filename", flowOutput);
-    cmd.AddValue("enableCsv", "Enable CSV export of FlowMonitor metrics", enableCsv);
-    cmd.AddValue("csvOutput", "CSV output filename if enableCsv=true", csvOutput);
+    cmd.AddValue("enableFlowMonitor", "Enable FlowMonitor and write XML", outputs.enableFlowMonitor);
+    cmd.AddValue("flowOutput", "FlowMonitor output filename", outputs.flowOutput);
+    cmd.AddValue("enableCsv", "Enable CSV export of FlowMonitor metrics", outputs.enableCsv);
+    cmd.AddValue("csvOutput", "CSV output filename if enableCsv=true", outputs.csvOutput);
+    cmd.AddValue("sampleInterval", "Sample per-sink throughput, loss, delay and jitter every this many seconds (0 = off)", outputs.sampleInterval);
+    cmd.AddValue("sampleOutput", "Time-series CSV filename if sampleInterval > 0", outputs.sampleOutput);
+    cmd.AddValue("sampleMaxRecords", "Maximum number of time-series records kept in memory (oldest are overwritten)", outputs.sampleMaxRecords);
+    cmd.AddValue("metricsFormat", "Metrics output format: xml (results + FlowMonitor XML) or binary (single columnar file)", outputs.metricsFormat);
+    cmd.AddValue("schedulerTrace", "Record the event scheduler operations to this binary file, for utils/bench-scheduler --replay", outputs.schedulerTrace);
     cmd.AddValue("duration", "Simulation duration in seconds", duration);
-    cmd.AddValue("enablePcap", "Enable PCAP capture (can generate large files)", enablePcap);
+    cmd.AddValue("enablePcap", "Enable PCAP capture (can generate large files)", outputs.enablePcap);
+    cmd.AddValue("pcapInterfaces", "PCAP capture points: all, ap, or a comma-separated list of node[:interface]", outputs.pcapInterfaces);
+    cmd.AddValue("pcapPorts", "Only capture packets whose source or destination port is in these ranges, e.g. 9001-9011", outputs.pcapPorts);
+    cmd.AddValue("pcapProtocol", "Only capture this transport protocol: all, tcp or udp", outputs.pcapProtocol);
+    cmd.AddValue("pcapSnapLen", "Bytes kept per captured packet (0 = whole packet)", outputs.pcapSnapLen);
+    cmd.AddValue("asyncTraces", "Write PCAP traces from a background thread fed by a lock-free ring buffer", outputs.asyncTraces);
+    cmd.AddValue("asyncBufferMb", "Ring buffer size in MiB for asyncTraces", outputs.asyncBufferMb);
+    cmd.AddValue("enableMlFeatures", "Compute the ML dataset features during the simulation (no PCAP needed)", outputs.enableMlFeatures);
+    cmd.AddValue("mlOutput", "ML dataset CSV filename if enableMlFeatures=true", outputs.mlOutput);
+    cmd.AddValue("mix", "Devices per application type, e.g. camera=5,sensor=10 or 5,10,3,2,4,4,1,1,1,1", mixSpec);
+    cmd.AddValue("mixFile", "Scenario file giving devices per application type (same syntax as --mix)", mixFile);
+    cmd.AddValue("profilesFile", "File of extra application profiles (ports, traffic model, metrics name, ML label), usable as --mix keys", profilesFile);
+    cmd.AddValue("exportProfiles", "Write the application profiles in effect (built-in, plus --profilesFile) in the profiles file format and exit", exportProfiles);
+    cmd.AddValue("mixScale", "Multiply every device count of the household by this factor", mixScale);
+    cmd.AddValue("replications", "Run this many independent replications (RngRun, RngRun+1, ...) in parallel processes", replications);
+    cmd.AddValue("jobs", "Maximum number of simultaneous replication or sweep processes (0 = all cores)", jobs);
+    cmd.AddValue("ciTarget", "Stop launching replications once every metric's relative 95% CI half-width is below this (e.g. 0.05; 0 = off)", ciTarget);
+    cmd.AddValue("minReplications", "Minimum number of replications per metric before ciTarget may stop the runs", minReplications);
+    cmd.AddValue("rateManager", "Wi-Fi remote station manager TypeId", rateManager);
+    cmd.AddValue("aps", "Number of access points (BSSs); above 1, stations join the nearest AP and APs reach the servers through a router", aps);
+    cmd.AddValue("floors", "Number of floors the access points are spread over", floors);
+    cmd.AddValue("roomSize", "Side in meters of the square room served by each access point", roomSize);
+    cmd.AddValue("floorHeight", "Height in meters of a floor", floorHeight);
+    cmd.AddValue("channelModel", "Wi-Fi channel model: yans (one channel object per Wi-Fi channel) or spectrum (multi-model spectrum channel with bandwidth filtering)", channelModel);
+    cmd.AddValue("wifiChannels", "Number of non-overlapping 5 GHz channels the BSSs are assigned to in turn", wifiChannels);
+    cmd.AddValue("wifiChannelWidth", "Channel width in MHz when wifiChannels > 1 (20, 40, 80 or 160)", wifiChannelWidth);
+    cmd.AddValue("rxCulling", "Spectrum channel only: skip receptions whose power at maximum transmit power is below cullThresholdDbm", rxCulling);
+    cmd.AddValue("cullThresholdDbm", "Received power threshold in dBm for rxCulling (default: WifiPhy RxSensitivity)", cullThresholdDbm);
+    cmd.AddValue("propagationCache", "Memoize propagation loss and delay per (tx, rx) pair in a dense matrix (static positions)", propagationCache);
+    cmd.AddValue("warmup", "Warm-up time in seconds: FlowMonitor and sink counters are reset then and metrics cover the rest of the run", warmup);
+    cmd.AddValue("steadyState", "Stop the simulation once every application's batch-mean throughput has converged (an application that receives no traffic never converges)", steadyState);
+    cmd.AddValue("steadyBatch", "Batch length in seconds for steadyState", steadyBatch);
+    cmd.AddValue("steadyTolerance", "Maximum relative 95% CI half-width of the batch-mean throughput for steadyState", steadyTolerance);
+    cmd.AddValue("steadyMinBatches", "Minimum number of batches before steadyState may stop the run", steadyMinBatches);
+    cmd.AddValue("mpi", "Distributed run under mpirun: each BSS (AP and its stations) goes to one process in turn, servers and router to process 0", mpi);
+    cmd.AddValue("mpiSync", "Distributed synchronization: null (null messages) or granted (granted-time windows)", mpiSync);
+    cmd.AddValue("sequentialRunSeconds", "Simulator::Run time of the same scenario in one process, to report the distributed speedup", sequentialRunSeconds);
+    cmd.AddValue("mtp", "Multithreaded run: each isolated home (BSS) is a logical process, synchronized every backhaul lookahead window", mtp);
+    cmd.AddValue("mtpThreads", "Number of threads for mtp (0 = all cores)", mtpThreads);
+    cmd.AddValue("fixedStreams", "Give every device a fixed block of RNG streams per (application type, device index), for common random numbers", fixedStreams);
+    cmd.AddValue("isolatedHomes", "One channel object per BSS: homes only interact through the backhaul (implied by mtp)", isolatedHomes);
+    cmd.AddValue("sweep", "Run a parameter sweep over the sweep* grids instead of a single simulation", sweep);
+    cmd.AddValue("sweepDuration", "Sweep grid of durations, e.g. 60|300|600", sweepDuration);
+    cmd.AddValue("sweepForceAc", "Sweep grid of forceAc values, e.g. true|false", sweepForceAc);
+    cmd.AddValue("sweepMix", "Sweep grid of household mixes, e.g. 5,10,3,2,4,4,1,1,1,1|camera=20", sweepMix);
+    cmd.AddValue("sweepRateManager", "Sweep grid of rate managers, e.g. ns3::MinstrelHtWifiManager|ns3::IdealWifiManager", sweepRateManager);
+    cmd.AddValue("sweepAps", "Sweep grid of access point counts, e.g. 1|16|128", sweepAps);
+    cmd.AddValue("sweepChannelModel", "Sweep grid of channel models, e.g. yans|spectrum", sweepChannelModel);
+    cmd.AddValue("sweepWifiChannels", "Sweep grid of channel counts, e.g. 1|6", sweepWifiChannels);
+    cmd.AddValue("sweepSeeds", "Number of RngRun values per sweep point, starting at RngRun", sweepSeeds);
+    cmd.AddValue("sweepStore", "Directory caching the results of already simulated sweep points", sweepStore);
+    cmd.AddValue("sweepOutput", "Single results table written at the end of the sweep", sweepOutput);
     cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(outputs.metricsFormat != "xml" && outputs.metricsFormat != "binary", "--metricsFormat doit valoir xml ou binary");
+    // Une seule trace par processus : chaque point de balayage ou réplication, chaque processus logique de --mtp l'écraserait
+    NS_ABORT_MSG_IF(!outputs.schedulerTrace.empty() && (sweep || replications > 0 || ciTarget > 0 || mtp),
+                    "--schedulerTrace ne se combine pas avec --sweep, --replications ni --mtp");
+    // Avant toute description du foyer : les profils ajoutés ont leurs effectifs par défaut et leurs clés --mix
+    std::string profilesError;
+    NS_ABORT_MSG_IF(!profilesFile.empty() && !LoadAppProfiles(profilesFile, profilesError), "--profilesFile : " << profilesError);
+    if (!exportProfiles.empty())
+    {
+        std::ofstream out(exportProfiles);
+        out << "# Profils d'application de simulation-domestique, écrits par --exportProfiles\n";
+        WriteAppProfiles(out, AppProfiles());
+        NS_ABORT_MSG_IF(!out, "--exportProfiles : impossible d'écrire " << exportProfiles);
+        return 0;
+    }
 
     // J'applique les options spécifiées en CLI
-    DUREE_SIMULATION = duration;
-    RunSimulation(forceAc, enableFlowMonitor, flowOutput, enablePcap, enableCsv, csvOutput);
+    ScenarioConfig config;
+    config.duration = duration;
+    config.forceAc = forceAc;
+    config.rateManager = rateManager;
+    config.aps = aps;
+    config.floors = floors;
+    config.roomSize = roomSize;
+    config.floorHeight = floorHeight;
+    config.channelModel = channelModel;
+    config.wifiChannels = wifiChannels;
+    config.wifiChannelWidth = wifiChannelWidth;
+    config.rxCulling = rxCulling;
+    config.cullThresholdDbm = cullThresholdDbm;
+    config.propagationCache = propagationCache;
+    config.isolatedHomes = isolatedHomes || mtp;
+    config.fixedStreams = fixedStreams;
+    config.warmup = warmup;
+    config.steadyState = steadyState;
+    config.steadyBatch = steadyBatch;
+    config.steadyTolerance = steadyTolerance;
+    config.steadyMinBatches = steadyMinBatches;
+    if (!mixFile.empty())
+    {
+        LoadHouseholdMix(mixFile, config.mix);
+    }
+    ParseHouseholdMix(mixSpec, config.mix);
+    for (uint32_t &count : config.mix.counts)
+    {
+        count *= mixScale;
+    }
+
+    if (mtp)
+    {
+#ifdef NS3_MTP
+        NS_ABORT_MSG_IF(mpi || sweep || replications > 0 || ciTarget > 0, "--mtp ne se combine pas avec --mpi, --sweep ni --replications");
+        // Avant la création des nœuds : le découpage en processus logiques suit les liens à délai non nul
+        if (mtpThreads > 0)
+        {
+            MtpInterface::Enable(mtpThreads);
+        }
+        else
+        {
+            MtpInterface::Enable();
+        }
+        g_multithreaded = true;
+#else
+        NS_ABORT_MSG("--mtp nécessite ns-3 compilé avec MTP (./ns3 configure --enable-mtp)");
+#endif
+    }
+
+    if (mpi)
+    {
+#ifdef NS3_MPI
+        NS_ABORT_MSG_IF(sweep || replications > 0 || ciTarget > 0, "--mpi ne se combine pas avec --sweep ni --replications");
+        NS_ABORT_MSG_IF(mpiSync != "null" && mpiSync != "granted", "--mpiSync doit valoir null ou granted");
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue(mpiSync == "null" ? "ns3::NullMessageSimulatorImpl" : "ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+        g_systemId = MpiInterface::GetSystemId();
+        g_systemCount = MpiInterface::GetSize();
+        g_outputPrefix = "rank" + std::to_string(g_systemId) + "-";
+
+        InitDebutAleatoire();
+        if (!outputs.schedulerTrace.empty())
+        {
+            InstallSchedulerRecorder(outputs);
+        }
+        RunSimulation(config, outputs);
+        ReportDistributedRun(sequentialRunSeconds);
+        Simulator::Destroy();
+        if (!outputs.schedulerTrace.empty())
+        {
+            ReportSchedulerTrace(outputs);
+        }
+        MpiInterface::Disable();
+        return 0;
+#else
+        NS_ABORT_MSG("--mpi nécessite ns-3 compilé avec MPI (./ns3 configure --enable-mpi)");
+#endif
+    }
+
+    if (sweep)
+    {
+        // Produit cartésien des grilles ; une grille vide garde la valeur de la configuration courante
+        std::vector<ScenarioConfig> configs{config};
+        auto expand = [&configs](const std::string &grid, const std::function<void(ScenarioConfig &, const std::string &)> &apply) {
+            std::vector<std::string> values = SplitList(grid, '|');
+            if (values.empty()) return;
+            std::vector<ScenarioConfig> expanded;
+            for (const ScenarioConfig &c : configs)
+            {
+                for (const std::string &v : values)
+                {
+                    ScenarioConfig point = c;
+                    apply(point, v);
+                    expanded.push_back(point);
+                }
+            }
+            configs = expanded;
+        };
+        expand(sweepDuration, [](ScenarioConfig &c, const std::string &v) { c.duration = std::stod(v); });
+        expand(sweepForceAc, [](ScenarioConfig &c, const std::string &v) { c.forceAc = (v == "true" || v == "1"); });
+        expand(sweepMix, [mixScale](ScenarioConfig &c, const std::string &v) {
+            c.mix = HouseholdMix();
+            ParseHouseholdMix(v, c.mix);
+            for (uint32_t &count : c.mix.counts) count *= mixScale;
+        });
+        expand(sweepRateManager, [](ScenarioConfig &c, const std::string &v) { c.rateManager = v; });
+        expand(sweepAps, [](ScenarioConfig &c, const std::string &v) { c.aps = ParseCount(v, "--sweepAps"); });
+        expand(sweepChannelModel, [](ScenarioConfig &c, const std::string &v) { c.channelModel = v; });
+        expand(sweepWifiChannels, [](ScenarioConfig &c, const std::string &v) { c.wifiChannels = ParseCount(v, "--sweepWifiChannels"); });
+        RunSweep(configs, sweepSeeds, RngSeedManager::GetRun(), sweepStore, sweepOutput, jobs);
+        return 0;
+    }
+
+    if (ciTarget > 0 && replications == 0)
+    {
+        // --replications fixe le nombre maximal de réplications ; par défaut celui du job de référence
+        replications = 30;
+    }
+    if (replications > 0)
+    {
+        // Le résumé par application nécessite FlowMonitor et l'export CSV
+        if (!outputs.enableFlowMonitor || !outputs.enableCsv)
+        {
+            NS_LOG_INFO("Mode réplications : activation de FlowMonitor et de l'export CSV");
+            outputs.enableFlowMonitor = true;
+            outputs.enableCsv = true;
+        }
+        auto runOnce = [&]() { RunSimulation(config, outputs); };
+        RunReplications(runOnce, outputs.csvOutput, replications, jobs, RngSeedManager::GetRun(), ciTarget, std::max<uint32_t>(2, minReplications));
+        return 0;
+    }
+
+    // Initialisation du générateur aléatoire (après lecture d'un éventuel --RngRun)
+    InitDebutAleatoire();
+    if (!outputs.schedulerTrace.empty())
+    {
+        InstallSchedulerRecorder(outputs);
+    }
+    RunSimulation(config, outputs);
 
     Simulator::Destroy ();
+    if (!outputs.schedulerTrace.empty())
+    {
+        ReportSchedulerTrace(outputs);
+    }
     return 0;
 }
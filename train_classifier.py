@@ -10,19 +10,15 @@ import seaborn as sns
 from sklearn.model_selection import train_test_split
 from sklearn.ensemble import RandomForestClassifier
 from sklearn.metrics import classification_report, confusion_matrix, accuracy_score
+from app_profiles import load_profiles
 
 # --- CONFIGURATION ---
 INPUT_CSV = "dataset_ml_features.csv"
 TEST_SIZE = 0.2
 RANDOM_STATE = 42
 
-# Mapping des labels (pour l'affichage)
-LABEL_MAP = {
-    1: 'Camera (UDP)', 2: 'Capteur (TCP)', 3: 'Assistant (TCP)', 
-    4: 'Download (TCP)', 5: 'VoIP (UDP)', 6: 'Domotique (UDP)', 
-    7: 'Streaming (TCP)', 8: 'Sonnette (TCP)', 9: 'Firmware (TCP)', 
-    10: 'Monitoring (UDP)'
-}
+# Nom des labels (pour l'affichage), rempli par les profils (app_profiles.load_profiles)
+LABEL_MAP = {}
 
 def train_model():
     print(f"--- Chargement du Dataset : {INPUT_CSV} ---")
@@ -91,4 +87,7 @@ def train_model():
     print("\nGraphique 'feature_importance.png' sauvegardé.")
 
 if __name__ == "__main__":
+    # --profiles=<fichier> : noms des LABEL des profils ajoutés à la simulation par --profilesFile
+    flows, _ = load_profiles()
+    LABEL_MAP.update({flow['label']: flow['name'] for flow in flows if flow['label'] > 0})
     train_model()
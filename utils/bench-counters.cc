@@ -0,0 +1,329 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "bench-counters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+/** Number of calls to the replacement operator new. */
+std::atomic<uint64_t> g_allocations{0};
+/** Bytes requested from the replacement operator new. */
+std::atomic<uint64_t> g_allocatedBytes{0};
+
+/**
+ * Allocate and count.
+ *
+ * @param [in] size The number of bytes.
+ * @returns The allocated block, or nullptr on failure.
+ */
+void*
+CountedAllocate(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+/**
+ * Allocate an over-aligned block and count.
+ *
+ * @param [in] size The number of bytes.
+ * @param [in] alignment The alignment, a power of two.
+ * @returns The allocated block, or nullptr on failure.
+ */
+void*
+CountedAllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc requires a size multiple of the alignment
+    return std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) & ~(align - 1));
+#endif
+}
+
+/**
+ * Release a block from CountedAllocateAligned().
+ *
+ * @param [in] p The block.
+ */
+void
+FreeAligned(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // unnamed namespace
+
+void*
+operator new(std::size_t size)
+{
+    void* p = CountedAllocate(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void*
+operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* p = CountedAllocateAligned(size, alignment);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void*
+operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void*
+operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void
+operator delete(void* p, std::align_val_t) noexcept
+{
+    FreeAligned(p);
+}
+
+void
+operator delete[](void* p, std::align_val_t) noexcept
+{
+    FreeAligned(p);
+}
+
+void
+operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(p);
+}
+
+void
+operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(p);
+}
+
+namespace ns3
+{
+
+BenchCounters::BenchCounters()
+    : m_enabled(false),
+      m_allocations(0),
+      m_allocatedBytes(0)
+{
+    for (auto& fd : m_fds)
+    {
+        fd = -1;
+    }
+}
+
+BenchCounters::~BenchCounters()
+{
+#ifdef __linux__
+    for (auto fd : m_fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool
+BenchCounters::Enable(std::string& error)
+{
+    m_enabled = true;
+#ifdef __linux__
+    const uint64_t configs[N_HARDWARE] = {PERF_COUNT_HW_CPU_CYCLES,
+                                          PERF_COUNT_HW_INSTRUCTIONS,
+                                          PERF_COUNT_HW_CACHE_MISSES,
+                                          PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < N_HARDWARE; ++i)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.disabled = (i == 0);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format =
+            PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        m_fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, m_fds[0], 0);
+        if (m_fds[i] < 0)
+        {
+            error = std::string("perf_event_open: ") + std::strerror(errno) +
+                    " (see /proc/sys/kernel/perf_event_paranoid)";
+            for (auto& fd : m_fds)
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+                fd = -1;
+            }
+            return false;
+        }
+    }
+    return true;
+#else
+    error = "hardware counters require Linux perf_event_open";
+    return false;
+#endif
+}
+
+bool
+BenchCounters::IsEnabled() const
+{
+    return m_enabled;
+}
+
+bool
+BenchCounters::HasHardware() const
+{
+    return m_fds[0] >= 0;
+}
+
+void
+BenchCounters::Start()
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+    m_allocations = g_allocations.load(std::memory_order_relaxed);
+    m_allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed);
+#ifdef __linux__
+    if (HasHardware())
+    {
+        ioctl(m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+BenchCounters::Values
+BenchCounters::Stop()
+{
+    Values values;
+    if (!m_enabled)
+    {
+        return values;
+    }
+#ifdef __linux__
+    if (HasHardware())
+    {
+        ioctl(m_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // The number of counters, the times enabled and running, then the values
+        uint64_t data[3 + N_HARDWARE];
+        if (read(m_fds[0], data, sizeof(data)) == (ssize_t)sizeof(data))
+        {
+            uint64_t enabled = data[1];
+            uint64_t running = data[2];
+            // Multiplexed group: extrapolate the counts to the whole section
+            double scale = 1.0;
+            if (running < enabled)
+            {
+                values.running = (double)running / enabled;
+                scale = running ? (double)enabled / running : 0.0;
+            }
+            values.cycles = (uint64_t)(data[3] * scale);
+            values.instructions = (uint64_t)(data[4] * scale);
+            values.cacheMisses = (uint64_t)(data[5] * scale);
+            values.branchMisses = (uint64_t)(data[6] * scale);
+        }
+    }
+#endif
+    values.allocations = g_allocations.load(std::memory_order_relaxed) - m_allocations;
+    values.allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed) - m_allocatedBytes;
+    return values;
+}
+
+} // namespace ns3
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef BENCH_COUNTERS_H
+#define BENCH_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ *  Hardware performance counters and heap allocation counts of a
+ *  measured section, for the bench-scheduler and bench-packets tools.
+ *
+ *  The hardware counters (cycles, instructions, cache misses and branch
+ *  misses, user space only) are read as one group through the Linux
+ *  perf_event_open system call. They are unavailable on other systems,
+ *  or when /proc/sys/kernel/perf_event_paranoid forbids them. When more
+ *  events are requested than the PMU has registers (other perf users, or
+ *  the NMI watchdog), the kernel time-multiplexes the group: the counts
+ *  are then scaled by the time enabled over the time running, and the
+ *  running fraction is reported so that such estimates can be flagged.
+ *
+ *  Allocations are counted by the replacement global operator new
+ *  defined in bench-counters.cc (plain, nothrow and aligned forms, for
+ *  single objects and arrays), which sees every C++ allocation of the
+ *  program, including those made inside the ns-3 libraries.
+ */
+class BenchCounters
+{
+  public:
+    /** Counter deltas over a measured section. */
+    struct Values
+    {
+        uint64_t cycles{0};         /**< CPU cycles. */
+        uint64_t instructions{0};   /**< Instructions retired. */
+        uint64_t cacheMisses{0};    /**< Last level cache misses. */
+        uint64_t branchMisses{0};   /**< Mispredicted branches. */
+        uint64_t allocations{0};    /**< Calls to operator new. */
+        uint64_t allocatedBytes{0}; /**< Bytes requested from operator new. */
+        /**
+         * Fraction of the section during which the hardware counters were
+         * counting. Below 1 when they were multiplexed with other events:
+         * the hardware counts are then scaled estimates.
+         */
+        double running{1.0};
+    };
+
+    BenchCounters();
+    ~BenchCounters();
+
+    /**
+     * Start counting in subsequent sections.
+     *
+     * @param [out] error Why the hardware counters are unavailable, if so.
+     * @returns \c true if the hardware counters could be opened;
+     *          allocations are counted in any case.
+     */
+    bool Enable(std::string& error);
+
+    /** @returns \c true once Enable() has been called. */
+    bool IsEnabled() const;
+
+    /** @returns \c true if the hardware counters are being read. */
+    bool HasHardware() const;
+
+    /** Reset and start the counters. */
+    void Start();
+
+    /**
+     * Stop the counters.
+     *
+     * @returns The counts since the last Start().
+     */
+    Values Stop();
+
+  private:
+    /** Number of hardware counters in the group. */
+    static constexpr int N_HARDWARE = 4;
+
+    bool m_enabled;              /**< Enable() has been called. */
+    int m_fds[N_HARDWARE];       /**< perf event descriptors, the first is the group leader. */
+    uint64_t m_allocations;      /**< Allocation count at Start(). */
+    uint64_t m_allocatedBytes;   /**< Allocated bytes at Start(). */
+};
+
+} // namespace ns3
+
+#endif // BENCH_COUNTERS_H
@@ -10,6 +10,9 @@
 // operations using Headers and Tags, for various numbers of packets 'n'
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
 
+#include "bench-counters.h"
+#include "bench-results.h"
+
 #include "ns3/command-line.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
@@ -24,6 +27,9 @@
 
 using namespace ns3;
 
+/// Hardware and allocation counters, enabled by --counters
+static BenchCounters g_counters;
+
 /// BenchHeader class used for benchmarking packet serialization/deserialization
 template <int N>
 class BenchHeader : public Header
@@ -340,29 +346,89 @@ benchByteTags(uint32_t n)
 }
 
 static uint64_t
-runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
+runBenchOneIteration(void (*bench)(uint32_t), uint32_t n, BenchCounters::Values& counters)
 {
     SystemWallClockMs time;
+    g_counters.Start();
     time.Start();
     (*bench)(n);
     uint64_t deltaMs = time.End();
+    counters = g_counters.Stop();
     return deltaMs;
 }
 
 static void
-runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char* name)
+runBench(void (*bench)(uint32_t),
+         uint32_t n,
+         uint32_t minIterations,
+         const char* name,
+         BenchResults& results)
 {
     uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    BenchCounters::Values minCounters;
     for (uint32_t i = 0; i < minIterations; i++)
     {
-        uint64_t delay = runBenchOneIteration(bench, n);
-        minDelay = std::min(minDelay, delay);
+        BenchCounters::Values counters;
+        uint64_t delay = runBenchOneIteration(bench, n, counters);
+        results.Add(name, "elapsed", "ms", delay);
+        results.Add(name, "rate", "packets/s", delay ? n * 1000.0 / delay : 0.0);
+        if (g_counters.IsEnabled())
+        {
+            if (g_counters.HasHardware())
+            {
+                results.Add(name, "cycles", "cycles/packet", (double)counters.cycles / n);
+                results.Add(name,
+                            "instructions",
+                            "instructions/packet",
+                            (double)counters.instructions / n);
+                results.Add(name, "cache_misses", "misses/packet", (double)counters.cacheMisses / n);
+                results.Add(name,
+                            "branch_misses",
+                            "misses/packet",
+                            (double)counters.branchMisses / n);
+            }
+            results.Add(name,
+                        "allocations",
+                        "allocations/packet",
+                        (double)counters.allocations / n);
+            results.Add(name,
+                        "allocated_bytes",
+                        "bytes/packet",
+                        (double)counters.allocatedBytes / n);
+        }
+        if (delay < minDelay)
+        {
+            minDelay = delay;
+            minCounters = counters;
+        }
     }
     double ps = n;
     ps *= 1000;
     ps /= minDelay;
     std::cout << ps << " packets/s"
               << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+
+    if (g_counters.IsEnabled())
+    {
+        // Counters of the fastest iteration, per packet
+        std::cout << "\tper packet:";
+        if (g_counters.HasHardware())
+        {
+            std::cout << " " << (double)minCounters.cycles / n << " cycles, "
+                      << (double)minCounters.instructions / n << " instructions (IPC "
+                      << (minCounters.cycles ? (double)minCounters.instructions / minCounters.cycles
+                                             : 0.0)
+                      << "), " << (double)minCounters.cacheMisses / n << " cache misses, "
+                      << (double)minCounters.branchMisses / n << " branch misses,";
+            if (minCounters.running < 1.0)
+            {
+                std::cout << " (multiplexed: counted " << 100 * minCounters.running
+                          << "% of the time, scaled)";
+            }
+        }
+        std::cout << " " << (double)minCounters.allocations / n << " allocations ("
+                  << (double)minCounters.allocatedBytes / n << " bytes)" << std::endl;
+    }
 }
 
 int
@@ -371,6 +437,8 @@ main(int argc, char* argv[])
     uint32_t n = 0;
     uint32_t minIterations = 1;
     bool enablePrinting = false;
+    bool counters = false;
+    std::string resultsFile = "";
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark Packet class");
@@ -379,6 +447,12 @@ main(int argc, char* argv[])
                  "number of subiterations to minimize iteration time over",
                  minIterations);
     cmd.AddValue("enable-printing", "enable packet printing", enablePrinting);
+    cmd.AddValue("counters",
+                 "record cycles, instructions, cache and branch misses and allocations",
+                 counters);
+    cmd.AddValue("results",
+                 "write every iteration to this file, as CSV (.csv) or JSON",
+                 resultsFile);
     cmd.Parse(argc, argv);
 
     if (n == 0)
@@ -389,13 +463,33 @@ main(int argc, char* argv[])
     }
     std::cout << "Running bench-packets with n=" << n << std::endl;
     std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
+    if (counters)
+    {
+        std::string error;
+        if (!g_counters.Enable(error))
+        {
+            std::cout << "Hardware counters unavailable, counting allocations only: " << error
+                      << std::endl;
+        }
+    }
 
-    runBench(&benchA, n, minIterations, "Copy packet, remove headers");
-    runBench(&benchB, n, minIterations, "Just add headers");
-    runBench(&benchC, n, minIterations, "Remove by func call");
-    runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
-    runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
-    runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    BenchResults results("bench-packets", argc, argv);
+    runBench(&benchA, n, minIterations, "Copy packet, remove headers", results);
+    runBench(&benchB, n, minIterations, "Just add headers", results);
+    runBench(&benchC, n, minIterations, "Remove by func call", results);
+    runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags", results);
+    runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation", results);
+    runBench(&benchByteTags, n, minIterations, "Benchmark byte tags", results);
+
+    if (!resultsFile.empty())
+    {
+        if (!results.Write(resultsFile))
+        {
+            std::cerr << "Error-- cannot write " << resultsFile << std::endl;
+            exit(1);
+        }
+        std::cout << "Results written to " << resultsFile << std::endl;
+    }
 
     return 0;
 }
@@ -0,0 +1,307 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "bench-results.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+/**
+ * Quote a string for JSON.
+ *
+ * @param [in] s The string.
+ * @returns The quoted and escaped string.
+ */
+std::string
+JsonString(const std::string& s)
+{
+    std::ostringstream os;
+    os << '"';
+    for (unsigned char c : s)
+    {
+        switch (c)
+        {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        case '\t':
+            os << "\\t";
+            break;
+        default:
+            if (c < 0x20)
+            {
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec;
+            }
+            else
+            {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+    return os.str();
+}
+
+/**
+ * Quote a CSV field if needed.
+ *
+ * @param [in] s The field.
+ * @returns The field, quoted if it contains a separator or a quote.
+ */
+std::string
+CsvField(const std::string& s)
+{
+    if (s.find_first_of(",\"\n") == std::string::npos)
+    {
+        return s;
+    }
+    std::string quoted = "\"";
+    for (char c : s)
+    {
+        quoted += c;
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+/**
+ * Format a number for JSON, which has no representation of NaN or infinity.
+ *
+ * @param [in] value The number.
+ * @returns The number, or `null`.
+ */
+std::string
+JsonNumber(double value)
+{
+    if (!std::isfinite(value))
+    {
+        return "null";
+    }
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    return os.str();
+}
+
+/** @returns The CPU model name, from /proc/cpuinfo where available. */
+std::string
+CpuModel()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.rfind("model name", 0) == 0)
+        {
+            auto colon = line.find(':');
+            if (colon != std::string::npos)
+            {
+                return line.substr(line.find_first_not_of(' ', colon + 1));
+            }
+        }
+    }
+    return "unknown";
+}
+
+} // unnamed namespace
+
+namespace ns3
+{
+
+BenchResults::BenchResults(const std::string& tool, int argc, char* argv[])
+{
+    std::string commandLine;
+    for (int i = 0; i < argc; ++i)
+    {
+        commandLine += (i ? " " : "") + std::string(argv[i]);
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::string host = "unknown";
+#ifdef __unix__
+    char hostname[256];
+    if (gethostname(hostname, sizeof(hostname)) == 0)
+    {
+        hostname[sizeof(hostname) - 1] = '\0';
+        host = hostname;
+    }
+#endif
+
+#if defined(NS3_BUILD_PROFILE_DEBUG)
+    std::string profile = "debug";
+#elif defined(NS3_BUILD_PROFILE_RELEASE)
+    std::string profile = "release";
+#elif defined(NS3_BUILD_PROFILE_OPTIMIZED)
+    std::string profile = "optimized";
+#else
+    std::string profile = "unknown";
+#endif
+
+#if defined(__clang__)
+    std::string compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    std::string compiler = "gcc " __VERSION__;
+#else
+    std::string compiler = "unknown";
+#endif
+
+    m_metadata = {
+        {"tool", tool},
+        {"command", commandLine},
+        {"date", date},
+        {"host", host},
+        {"cpu", CpuModel()},
+        {"cores", std::to_string(std::thread::hardware_concurrency())},
+        {"compiler", compiler},
+        {"build_profile", profile},
+    };
+}
+
+void
+BenchResults::Add(const std::string& benchmark,
+                  const std::string& metric,
+                  const std::string& unit,
+                  double value)
+{
+    auto it = std::find_if(m_series.begin(), m_series.end(), [&](const Series& s) {
+        return s.benchmark == benchmark && s.metric == metric;
+    });
+    if (it == m_series.end())
+    {
+        m_series.push_back(Series{benchmark, metric, unit, {}});
+        it = m_series.end() - 1;
+    }
+    it->values.push_back(value);
+}
+
+/* static */
+BenchResults::Summary
+BenchResults::Summarize(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    std::size_t n = values.size();
+
+    double mean = 0;
+    for (double v : values)
+    {
+        mean += v;
+    }
+    mean /= n;
+    double squares = 0;
+    for (double v : values)
+    {
+        squares += (v - mean) * (v - mean);
+    }
+
+    // Linear interpolation between the closest ranks
+    auto percentile = [&values, n](double p) {
+        double rank = p * (n - 1);
+        std::size_t lo = (std::size_t)rank;
+        std::size_t hi = std::min(lo + 1, n - 1);
+        return values[lo] + (rank - lo) * (values[hi] - values[lo]);
+    };
+
+    return Summary{mean,
+                   n > 1 ? std::sqrt(squares / (n - 1)) : 0.0,
+                   values.front(),
+                   percentile(0.5),
+                   percentile(0.9),
+                   percentile(0.99),
+                   values.back()};
+}
+
+bool
+BenchResults::Write(const std::string& filename) const
+{
+    std::ofstream os(filename);
+    if (!os)
+    {
+        return false;
+    }
+    bool csv = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0;
+    if (csv)
+    {
+        WriteCsv(os);
+    }
+    else
+    {
+        WriteJson(os);
+    }
+    return bool(os);
+}
+
+void
+BenchResults::WriteCsv(std::ostream& os) const
+{
+    for (const auto& [key, value] : m_metadata)
+    {
+        os << "# " << key << ": " << value << "\n";
+    }
+    os << "benchmark,metric,unit,n,mean,stdev,min,p50,p90,p99,max\n";
+    os << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& series : m_series)
+    {
+        auto s = Summarize(series.values);
+        os << CsvField(series.benchmark) << "," << CsvField(series.metric) << ","
+           << CsvField(series.unit) << "," << series.values.size() << "," << s.mean << ","
+           << s.stdev << "," << s.min << "," << s.p50 << "," << s.p90 << "," << s.p99 << ","
+           << s.max << "\n";
+    }
+}
+
+void
+BenchResults::WriteJson(std::ostream& os) const
+{
+    os << "{\n  \"metadata\": {";
+    for (std::size_t i = 0; i < m_metadata.size(); ++i)
+    {
+        os << (i ? ",\n    " : "\n    ") << JsonString(m_metadata[i].first) << ": "
+           << JsonString(m_metadata[i].second);
+    }
+    os << "\n  },\n  \"results\": [";
+    for (std::size_t i = 0; i < m_series.size(); ++i)
+    {
+        const auto& series = m_series[i];
+        auto s = Summarize(series.values);
+        os << (i ? ",\n    {" : "\n    {") << "\"benchmark\": " << JsonString(series.benchmark)
+           << ", \"metric\": " << JsonString(series.metric)
+           << ", \"unit\": " << JsonString(series.unit) << ", \"n\": " << series.values.size()
+           << ", \"mean\": " << JsonNumber(s.mean) << ", \"stdev\": " << JsonNumber(s.stdev)
+           << ", \"min\": " << JsonNumber(s.min) << ", \"p50\": " << JsonNumber(s.p50)
+           << ", \"p90\": " << JsonNumber(s.p90) << ", \"p99\": " << JsonNumber(s.p99)
+           << ", \"max\": " << JsonNumber(s.max) << ", \"samples\": [";
+        for (std::size_t j = 0; j < series.values.size(); ++j)
+        {
+            os << (j ? ", " : "") << JsonNumber(series.values[j]);
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+} // namespace ns3
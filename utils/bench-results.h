@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef BENCH_RESULTS_H
+#define BENCH_RESULTS_H
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ *  Machine readable results of the bench-scheduler, bench-packets and
+ *  perf-io tools, compared by utils/compare-bench-results.py.
+ *
+ *  Each benchmark metric accumulates one sample per run. The output
+ *  gives, per metric, the sample count, mean, standard deviation, min,
+ *  median, 90th and 99th percentiles and max, together with metadata
+ *  about the environment: tool, command line, date, host, CPU, compiler
+ *  and build profile.
+ *
+ *  Two formats are supported, chosen by the file name extension:
+ *  - `.csv`: one row per metric, metadata as leading `# key: value` lines;
+ *  - anything else: JSON, which also keeps the raw samples.
+ */
+class BenchResults
+{
+  public:
+    /**
+     * Constructor
+     *
+     * @param [in] tool The name of the benchmark program.
+     * @param [in] argc The argument count, for the metadata.
+     * @param [in] argv The arguments, for the metadata.
+     */
+    BenchResults(const std::string& tool, int argc, char* argv[]);
+
+    /**
+     * Add a sample.
+     *
+     * @param [in] benchmark The benchmark, for example the scheduler name.
+     * @param [in] metric The metric within the benchmark.
+     * @param [in] unit The metric unit.
+     * @param [in] value The sample.
+     */
+    void Add(const std::string& benchmark,
+             const std::string& metric,
+             const std::string& unit,
+             double value);
+
+    /**
+     * Write the results, as CSV or JSON depending on the extension.
+     *
+     * @param [in] filename The output file name.
+     * @returns \c false if the file could not be written.
+     */
+    bool Write(const std::string& filename) const;
+
+  private:
+    /** Samples of one benchmark metric. */
+    struct Series
+    {
+        std::string benchmark;      /**< Benchmark name. */
+        std::string metric;         /**< Metric name. */
+        std::string unit;           /**< Metric unit. */
+        std::vector<double> values; /**< One sample per run. */
+    };
+
+    /** Summary statistics of a Series. */
+    struct Summary
+    {
+        double mean;  /**< Arithmetic mean. */
+        double stdev; /**< Sample standard deviation (n - 1). */
+        double min;   /**< Minimum. */
+        double p50;   /**< Median. */
+        double p90;   /**< 90th percentile. */
+        double p99;   /**< 99th percentile. */
+        double max;   /**< Maximum. */
+    };
+
+    /**
+     * Summarize a series.
+     *
+     * @param [in] values The samples, not empty.
+     * @returns The summary statistics.
+     */
+    static Summary Summarize(std::vector<double> values);
+
+    /**
+     * Write the CSV format.
+     *
+     * @param [in] os The output stream.
+     */
+    void WriteCsv(std::ostream& os) const;
+
+    /**
+     * Write the JSON format.
+     *
+     * @param [in] os The output stream.
+     */
+    void WriteJson(std::ostream& os) const;
+
+    /** Environment metadata, as (key, value) pairs. */
+    std::vector<std::pair<std::string, std::string>> m_metadata;
+    /** The metrics, in insertion order. */
+    std::vector<Series> m_series;
+};
+
+} // namespace ns3
+
+#endif // BENCH_RESULTS_H
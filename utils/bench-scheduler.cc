@@ -6,12 +6,22 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include "bench-counters.h"
+#include "bench-results.h"
+
 #include "ns3/core-module.h"
 
+#include "simulation-domestique-dary-heap-scheduler.h"
+#include "simulation-domestique-ladder-scheduler.h"
+#include "simulation-domestique-scheduler-trace.h"
+
+#include <algorithm>
 #include <cmath> // sqrt
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string.h>
 #include <vector>
 
@@ -36,6 +46,9 @@ std::string g_me;
 /** Output field width for numeric data. */
 int g_fwidth = 6;
 
+/** Hardware and allocation counters of the simulation phase. */
+BenchCounters g_counters;
+
 /**
  *  Benchmark instance which can do a single run.
  *
@@ -96,6 +109,7 @@ class Bench
         double simu;     /**< Time (s) for simulation. */
         uint64_t pop;    /**< Event population. */
         uint64_t events; /**< Number of events executed. */
+        BenchCounters::Values counters; /**< Simulation phase counters, if enabled. */
     };
 
     /**
@@ -138,14 +152,16 @@ Bench::Run()
     DEB("initialization took " << init << "s");
 
     DEB("running");
+    g_counters.Start();
     timer.Start();
     Simulator::Run();
     simu = timer.End() / 1000.0;
+    auto counters = g_counters.Stop();
     DEB("run took " << simu << "s");
 
     Simulator::Destroy();
 
-    return Result{init, simu, m_population, m_count};
+    return Result{init, simu, m_population, m_count, counters};
 }
 
 void
@@ -163,6 +179,112 @@ Bench::Cb()
     ++m_count;
 }
 
+/**
+ *  Replay of a scheduler trace recorded by simulation-domestique
+ *  (--schedulerTrace, see RecordingScheduler).
+ *
+ *  The recorded Insert, RemoveNext and Remove operations are applied
+ *  directly to a fresh scheduler, so only the scheduler itself is timed.
+ *  The initialization phase covers the operations before the first
+ *  RemoveNext; the simulation phase covers the rest of the trace.
+ */
+class Replay
+{
+  public:
+    /**
+     * Constructor
+     * @param [in] records The decoded trace.
+     */
+    Replay(const std::vector<SchedulerTraceRecord>& records);
+
+    /**
+     *  Replay the trace once against a new scheduler.
+     *
+     * @param [in] factory Factory pre-configured to create the desired Scheduler.
+     * @returns The Result, with the initial population and the number of
+     *          events removed by RemoveNext.
+     */
+    Bench::Result Run(ObjectFactory& factory) const;
+
+  private:
+    /**
+     *  Apply one recorded operation.
+     *
+     * @param [in] scheduler The scheduler.
+     * @param [in] record The operation.
+     * @returns \c false if RemoveNext did not return the recorded event.
+     */
+    static bool Apply(Ptr<Scheduler> scheduler, const SchedulerTraceRecord& record);
+
+    const std::vector<SchedulerTraceRecord>& m_records; /**< The decoded trace. */
+    std::size_t m_initEnd;                             /**< Index of the first RemoveNext. */
+    uint64_t m_removed;                                /**< Number of RemoveNext operations. */
+};
+
+Replay::Replay(const std::vector<SchedulerTraceRecord>& records)
+    : m_records(records),
+      m_initEnd(records.size()),
+      m_removed(0)
+{
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        if (records[i].op == TRACE_REMOVE_NEXT)
+        {
+            m_initEnd = std::min(m_initEnd, i);
+            ++m_removed;
+        }
+    }
+}
+
+bool
+Replay::Apply(Ptr<Scheduler> scheduler, const SchedulerTraceRecord& record)
+{
+    switch (record.op)
+    {
+    case TRACE_INSERT:
+        scheduler->Insert(Scheduler::Event{nullptr, record.key});
+        return true;
+    case TRACE_REMOVE:
+        scheduler->Remove(Scheduler::Event{nullptr, record.key});
+        return true;
+    default:
+        // As in the simulator main loop
+        return !scheduler->IsEmpty() && scheduler->RemoveNext().key.m_ts == record.key.m_ts;
+    }
+}
+
+Bench::Result
+Replay::Run(ObjectFactory& factory) const
+{
+    SystemWallClockMs timer;
+    double init;
+    double simu;
+    bool ok = true;
+
+    Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+
+    DEB("replaying " << m_initEnd << " initial operations");
+    timer.Start();
+    for (std::size_t i = 0; i < m_initEnd; ++i)
+    {
+        ok &= Apply(scheduler, m_records[i]);
+    }
+    init = timer.End() / 1000.0;
+
+    DEB("replaying " << m_records.size() - m_initEnd << " operations");
+    g_counters.Start();
+    timer.Start();
+    for (std::size_t i = m_initEnd; i < m_records.size(); ++i)
+    {
+        ok &= Apply(scheduler, m_records[i]);
+    }
+    simu = timer.End() / 1000.0;
+    auto counters = g_counters.Stop();
+    NS_ABORT_MSG_UNLESS(ok, "Replay: the scheduler did not return the recorded events");
+
+    return Bench::Result{init, simu, m_initEnd, m_removed, counters};
+}
+
 /** Benchmark which performs an ensemble of runs. */
 class BenchSuite
 {
@@ -189,13 +311,52 @@ class BenchSuite
                Ptr<RandomVariableStream> eventStream,
                bool calRev);
 
+    /**
+     * Replay a recorded trace for a single scheduler type.
+     *
+     * This will execute a priming replay followed by the number of
+     * data replays requested, each against a new scheduler.
+     *
+     * @param [in] factory Factory pre-configured to create the desired Scheduler.
+     * @param [in] runs The number of replications.
+     * @param [in] replay The trace replay.
+     * @param [in] calRev For the CalendarScheduler, whether the Reverse attribute was set.
+     */
+    BenchSuite(ObjectFactory& factory, uint64_t runs, const Replay& replay, bool calRev);
+
     /** Write the results to \c LOG() */
     void Log() const;
 
+    /**
+     * Add the samples of each run to the machine readable results.
+     *
+     * @param [in,out] results The results collection.
+     */
+    void Record(BenchResults& results) const;
+
   private:
     /** Print the table header. */
     void Header() const;
 
+    /** Print the per event counters of each run, if enabled. */
+    void LogCounters() const;
+
+    /**
+     * Set the descriptive scheduler name.
+     *
+     * @param [in] factory Factory pre-configured to create the desired Scheduler.
+     * @param [in] calRev For the CalendarScheduler, whether the Reverse attribute was set.
+     */
+    void SetName(ObjectFactory& factory, bool calRev);
+
+    /**
+     * Execute the priming run and the data runs.
+     *
+     * @param [in] run Perform a single run.
+     * @param [in] runs The number of replications.
+     */
+    void Runs(std::function<Bench::Result()> run, uint64_t runs);
+
     /** Statistics from a single phase, init or run. */
     struct PhaseResult
     {
@@ -209,6 +370,8 @@ class BenchSuite
     {
         PhaseResult init; /**< Initialization phase results. */
         PhaseResult run;  /**< Run (simulation) phase results. */
+        uint64_t events;  /**< Number of events executed. */
+        BenchCounters::Values counters; /**< Run phase counters. */
         /**
          * Construct from the individual run result.
          *
@@ -237,7 +400,9 @@ BenchSuite::Result
 BenchSuite::Result::Bench(Bench::Result r)
 {
     return Result{{r.init, r.pop / r.init, r.init / r.pop},
-                  {r.simu, r.events / r.simu, r.simu / r.events}};
+                  {r.simu, r.events / r.simu, r.simu / r.events},
+                  r.events,
+                  r.counters};
 }
 
 template <typename T>
@@ -260,7 +425,27 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
                        bool calRev)
 {
     Simulator::SetScheduler(factory);
+    SetName(factory, calRev);
 
+    Bench bench(pop, total);
+    bench.SetRandomStream(eventStream);
+    bench.SetPopulation(pop);
+    bench.SetTotal(total);
+
+    Runs([&bench]() { return bench.Run(); }, runs);
+
+    Simulator::Destroy();
+}
+
+BenchSuite::BenchSuite(ObjectFactory& factory, uint64_t runs, const Replay& replay, bool calRev)
+{
+    SetName(factory, calRev);
+    Runs([&factory, &replay]() { return replay.Run(factory); }, runs);
+}
+
+void
+BenchSuite::SetName(ObjectFactory& factory, bool calRev)
+{
     m_scheduler = factory.GetTypeId().GetName();
     if (m_scheduler == "ns3::CalendarScheduler")
     {
@@ -270,29 +455,25 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     {
         m_scheduler += " (default)";
     }
+}
 
-    Bench bench(pop, total);
-    bench.SetRandomStream(eventStream);
-    bench.SetPopulation(pop);
-    bench.SetTotal(total);
-
+void
+BenchSuite::Runs(std::function<Bench::Result()> run, uint64_t runs)
+{
     m_results.reserve(runs);
     Header();
 
     // Prime
     DEB("priming");
-    auto prime = bench.Run();
+    auto prime = run();
     Result::Bench(prime).Log("prime");
 
     // Perform the actual runs
     for (uint64_t i = 0; i < runs; i++)
     {
-        auto run = bench.Run();
-        m_results.push_back(Result::Bench(run));
+        m_results.push_back(Result::Bench(run()));
         m_results.back().Log(i);
     }
-
-    Simulator::Destroy();
 }
 
 void
@@ -320,6 +501,7 @@ BenchSuite::Log() const
 {
     if (m_results.size() < 2)
     {
+        LogCounters();
         LOG("");
         return;
     }
@@ -333,7 +515,9 @@ BenchSuite::Log() const
     uint64_t n{0};                // number of samples
     Result average{m_results[0]}; // average
     Result moment2{{0, 0, 0},     // 2nd moment, to calculate stdev
-                   {0, 0, 0}};
+                   {0, 0, 0},
+                   0,
+                   {}};
 
     for (; n < m_results.size(); ++n)
     {
@@ -365,12 +549,120 @@ BenchSuite::Log() const
         {std::sqrt(moment2.run.time / n),
          std::sqrt(moment2.run.rate / n),
          std::sqrt(moment2.run.period / n)},
+        0,
+        {},
     };
 
     average.Log("average");
     stdev.Log("stdev");
 
+    LogCounters();
+    LOG("");
+}
+
+void
+BenchSuite::Record(BenchResults& results) const
+{
+    for (const auto& r : m_results)
+    {
+        results.Add(m_scheduler, "init_time", "s", r.init.time);
+        results.Add(m_scheduler, "init_rate", "events/s", r.init.rate);
+        results.Add(m_scheduler, "run_time", "s", r.run.time);
+        results.Add(m_scheduler, "run_rate", "events/s", r.run.rate);
+        results.Add(m_scheduler, "run_period", "s/event", r.run.period);
+        if (g_counters.IsEnabled())
+        {
+            double events = r.events ? r.events : 1;
+            if (g_counters.HasHardware())
+            {
+                results.Add(m_scheduler, "cycles", "cycles/event", r.counters.cycles / events);
+                results.Add(m_scheduler,
+                            "instructions",
+                            "instructions/event",
+                            r.counters.instructions / events);
+                results.Add(m_scheduler,
+                            "cache_misses",
+                            "misses/event",
+                            r.counters.cacheMisses / events);
+                results.Add(m_scheduler,
+                            "branch_misses",
+                            "misses/event",
+                            r.counters.branchMisses / events);
+            }
+            results.Add(m_scheduler,
+                        "allocations",
+                        "allocations/event",
+                        r.counters.allocations / events);
+            results.Add(m_scheduler,
+                        "allocated_bytes",
+                        "bytes/event",
+                        r.counters.allocatedBytes / events);
+        }
+    }
+}
+
+void
+BenchSuite::LogCounters() const
+{
+    if (!g_counters.IsEnabled())
+    {
+        return;
+    }
+
     LOG("");
+    LOG("Simulation per event:");
+    LOG(std::left << std::setw(g_fwidth) << "Run #" << std::setw(g_fwidth) << "Cycles"
+                  << std::setw(g_fwidth) << "Instr" << std::setw(g_fwidth) << "IPC"
+                  << std::setw(g_fwidth) << "LLC miss" << std::setw(g_fwidth) << "Br miss"
+                  << std::setw(g_fwidth) << "Allocs" << "Bytes");
+
+    BenchCounters::Values total;
+    uint64_t events = 0;
+    auto logLine = [](auto label, const BenchCounters::Values& c, uint64_t n) {
+        double count = n ? n : 1;
+        std::ostringstream hardware;
+        hardware << std::left;
+        if (g_counters.HasHardware())
+        {
+            hardware << std::setw(g_fwidth) << c.cycles / count << std::setw(g_fwidth)
+                     << c.instructions / count << std::setw(g_fwidth)
+                     << (c.cycles ? (double)c.instructions / c.cycles : 0.0)
+                     << std::setw(g_fwidth) << c.cacheMisses / count << std::setw(g_fwidth)
+                     << c.branchMisses / count;
+        }
+        else
+        {
+            for (int i = 0; i < 5; ++i)
+            {
+                hardware << std::setw(g_fwidth) << "-";
+            }
+        }
+        std::ostringstream multiplexed;
+        if (g_counters.HasHardware() && c.running < 1.0)
+        {
+            multiplexed << "  (multiplexed: counted " << 100 * c.running
+                        << "% of the time, scaled)";
+        }
+        LOG(std::left << std::setw(g_fwidth) << label << hardware.str() << std::setw(g_fwidth)
+                      << c.allocations / count << c.allocatedBytes / count << multiplexed.str());
+    };
+    for (std::size_t i = 0; i < m_results.size(); ++i)
+    {
+        const auto& c = m_results[i].counters;
+        logLine(i, c, m_results[i].events);
+        total.cycles += c.cycles;
+        total.instructions += c.instructions;
+        total.cacheMisses += c.cacheMisses;
+        total.branchMisses += c.branchMisses;
+        total.allocations += c.allocations;
+        total.allocatedBytes += c.allocatedBytes;
+        total.running = std::min(total.running, c.running);
+        events += m_results[i].events;
+    }
+    if (m_results.size() > 1)
+    {
+        logLine("average", total, events);
+    }
 }
 
 /**
@@ -437,12 +729,57 @@ GetRandomStream(std::string filename)
     return stream;
 }
 
+/**
+ *  Create a RandomVariableStream reproducing the bimodal delays of
+ *  simulation-domestique: mostly PHY/MAC timers, exponential with mean
+ *  20 us, mixed with application timers of 300 s (sensor OffTime, with
+ *  probability \p slow * 6/7) and 3600 s (doorbell OffTime).
+ *
+ *  The delays are drawn once, so every scheduler sees the same sequence.
+ *
+ *  @param [in] slow The fraction of application timers.
+ *  @returns The RandomVariableStream.
+ */
+Ptr<RandomVariableStream>
+GetBimodalStream(double slow)
+{
+    LOG("  Event time distribution:      bimodal, exponential 20 us + "
+        << slow * 100 << "% of 300 s / 3600 s");
+
+    auto fast = CreateObject<ExponentialRandomVariable>();
+    fast->SetAttribute("Mean", DoubleValue(20000));
+    auto choice = CreateObject<UniformRandomVariable>();
+
+    std::vector<double> nsValues(1 << 20);
+    for (auto& value : nsValues)
+    {
+        double u = choice->GetValue();
+        if (u >= slow)
+        {
+            value = fast->GetValue();
+        }
+        else if (u < slow * 6 / 7)
+        {
+            value = 300e9;
+        }
+        else
+        {
+            value = 3600e9;
+        }
+    }
+    auto drv = CreateObject<DeterministicRandomVariable>();
+    drv->SetValueArray(&nsValues[0], nsValues.size());
+    return drv;
+}
+
 int
 main(int argc, char* argv[])
 {
     bool allSched = false;
     bool schedCal = false;
+    bool schedDary = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -451,6 +788,11 @@ main(int argc, char* argv[])
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
+    std::string replayFile = "";
+    bool bimodal = false;
+    double bimodalSlow = 0.01;
+    bool counters = false;
+    std::string resultsFile = "";
     bool calRev = false;
 
     CommandLine cmd(__FILE__);
@@ -462,12 +804,20 @@ main(int argc, char* argv[])
               "  or standard input, by the argument --file=\"-\"\n"
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
+              "The --bimodal preset mixes 20 us PHY/MAC timers with\n"
+              "300 s and 3600 s application timers, as in simulation-domestique.\n"
+              "\n"
+              "Alternatively --replay=\"<filename>\" replays the scheduler operations\n"
+              "recorded by simulation-domestique --schedulerTrace; --pop, --total\n"
+              "and --file are then ignored.\n"
               "\n"
               "If no scheduler is specified the MapScheduler will be run.");
     cmd.AddValue("all", "use all schedulers", allSched);
     cmd.AddValue("cal", "use CalendarScheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
+    cmd.AddValue("dary", "use DaryHeapScheduler", schedDary);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
@@ -476,68 +826,145 @@ main(int argc, char* argv[])
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("bimodal", "use the bimodal simulation-domestique preset", bimodal);
+    cmd.AddValue("bimodalSlow", "fraction of application timers in the bimodal preset", bimodalSlow);
+    cmd.AddValue("replay", "scheduler trace to replay", replayFile);
+    cmd.AddValue("counters",
+                 "record cycles, instructions, cache and branch misses and allocations",
+                 counters);
+    cmd.AddValue("results",
+                 "write the results to this file, as CSV (.csv) or JSON",
+                 resultsFile);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
     cmd.Parse(argc, argv);
 
     g_me = cmd.GetName() + ": ";
     g_fwidth += 6; // 5 extra chars in '2.000002e+07 ': . e+0 _
 
+    std::vector<SchedulerTraceRecord> records;
+    if (!replayFile.empty())
+    {
+        std::string error;
+        NS_ABORT_MSG_UNLESS(ReadSchedulerTrace(replayFile, records, error), error);
+    }
+    Replay replay(records);
+
     LOG(std::setprecision(g_fwidth - 6)); // prints blank line
     LOGME(" Benchmark the simulator scheduler");
-    LOG("  Event population size:        " << pop);
-    LOG("  Total events per run:         " << total);
+    if (replayFile.empty())
+    {
+        LOG("  Event population size:        " << pop);
+        LOG("  Total events per run:         " << total);
+    }
+    else
+    {
+        auto inserts = std::count_if(records.begin(), records.end(), [](const auto& r) {
+            return r.op == TRACE_INSERT;
+        });
+        auto removes = std::count_if(records.begin(), records.end(), [](const auto& r) {
+            return r.op == TRACE_REMOVE;
+        });
+        LOG("  Replayed trace:               " << replayFile);
+        LOG("  Operations per run:           " << records.size());
+        LOG("  Insert / RemoveNext / Remove: " << inserts << " / "
+                                               << records.size() - inserts - removes << " / "
+                                               << removes);
+    }
     LOG("  Number of runs per scheduler: " << runs);
+    if (counters)
+    {
+        std::string error;
+        if (g_counters.Enable(error))
+        {
+            LOG("  Counters:                     hardware and allocations");
+        }
+        else
+        {
+            LOG("  Counters:                     allocations only, " << error);
+        }
+    }
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedDary = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedDary || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    Ptr<RandomVariableStream> eventStream;
+    if (replayFile.empty())
+    {
+        NS_ABORT_MSG_IF(bimodal && !filename.empty(), "--bimodal and --file are exclusive");
+        eventStream = bimodal ? GetBimodalStream(bimodalSlow) : GetRandomStream(filename);
+    }
+
+    BenchResults results("bench-scheduler", argc, argv);
+
+    // Run one suite, synthetic or replayed
+    auto suite = [&](ObjectFactory& f, uint64_t suiteTotal, bool rev) {
+        auto bench = replayFile.empty() ? BenchSuite(f, pop, suiteTotal, runs, eventStream, rev)
+                                        : BenchSuite(f, runs, replay, rev);
+        bench.Log();
+        bench.Record(results);
+    };
 
     ObjectFactory factory("ns3::MapScheduler");
     if (schedCal)
     {
         factory.SetTypeId("ns3::CalendarScheduler");
         factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suite(factory, total, calRev);
         if (allSched)
         {
             factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            suite(factory, total, !calRev);
         }
     }
+    if (schedDary)
+    {
+        factory.SetTypeId("ns3::DaryHeapScheduler");
+        suite(factory, total, calRev);
+    }
     if (schedHeap)
     {
         factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suite(factory, total, calRev);
+    }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        suite(factory, total, calRev);
     }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");
         auto listTotal = total;
-        if (allSched)
+        if (allSched && replayFile.empty())
         {
             LOG("Running List scheduler with 1/10 total events");
             listTotal /= 10;
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        suite(factory, listTotal, calRev);
     }
     if (schedMap)
     {
         factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suite(factory, total, calRev);
     }
     if (schedPQ)
     {
         factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        suite(factory, total, calRev);
+    }
+
+    if (!resultsFile.empty())
+    {
+        NS_ABORT_MSG_UNLESS(results.Write(resultsFile), "Cannot write " << resultsFile);
+        LOGME(" results written to " << resultsFile);
     }
 
     return 0;
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+
+# SPDX-License-Identifier: GPL-2.0-only
+
+"""
+Compare two result files written by bench-scheduler, bench-packets or perf-io
+(--results=<file>, JSON or CSV) and flag statistically significant regressions.
+
+Metrics are matched by (benchmark, metric). For each pair, Welch's t-test
+(unequal variances) is computed from the sample count, mean and standard
+deviation of both files. A metric regresses when the difference is significant
+(p < --alpha) and the candidate is worse than the baseline by more than
+--threshold (relative). Rates (units ending in "/s") are better when higher,
+every other metric (times, cycles, allocations, ...) when lower.
+
+The exit status is 1 if any metric regressed, so the script can gate CI jobs:
+
+    ./utils/compare-bench-results.py baseline.json candidate.json
+"""
+
+import argparse
+import csv
+import json
+import math
+import sys
+
+
+def load_results(filename):
+    """Return ({(benchmark, metric): summary}, metadata) from a JSON or CSV result file."""
+    metadata = {}
+    results = {}
+    if filename.endswith(".csv"):
+        with open(filename, newline="") as f:
+            rows = []
+            for line in f:
+                if line.startswith("#"):
+                    key, _, value = line[1:].strip().partition(":")
+                    metadata[key.strip()] = value.strip()
+                else:
+                    rows.append(line)
+        for row in csv.DictReader(rows):
+            results[(row["benchmark"], row["metric"])] = {
+                "unit": row["unit"],
+                "n": int(row["n"]),
+                "mean": float(row["mean"]),
+                "stdev": float(row["stdev"]),
+            }
+    else:
+        with open(filename) as f:
+            data = json.load(f)
+        metadata = data.get("metadata", {})
+        for entry in data["results"]:
+            results[(entry["benchmark"], entry["metric"])] = {
+                "unit": entry["unit"],
+                "n": int(entry["n"]),
+                "mean": float(entry["mean"]) if entry["mean"] is not None else math.nan,
+                "stdev": float(entry["stdev"]) if entry["stdev"] is not None else math.nan,
+            }
+    return results, metadata
+
+
+def betacf(a, b, x):
+    """Continued fraction of the incomplete beta function (modified Lentz)."""
+    tiny = 1e-300
+    c = 1.0
+    d = 1.0 - (a + b) * x / (a + 1.0)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, 300):
+        m2 = 2 * m
+        for numerator in (
+            m * (b - m) * x / ((a + m2 - 1.0) * (a + m2)),
+            -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0)),
+        ):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            h *= d * c
+        if abs(d * c - 1.0) < 1e-14:
+            break
+    return h
+
+
+def betainc(a, b, x):
+    """Regularized incomplete beta function I_x(a, b)."""
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    front = math.exp(
+        math.lgamma(a + b)
+        - math.lgamma(a)
+        - math.lgamma(b)
+        + a * math.log(x)
+        + b * math.log(1.0 - x)
+    )
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * betacf(a, b, x) / a
+    return 1.0 - front * betacf(b, a, 1.0 - x) / b
+
+
+def welch_test(base, cand):
+    """Return (t, degrees of freedom, two-sided p-value), or None if undefined."""
+    if base["n"] < 2 or cand["n"] < 2:
+        return None
+    vb = base["stdev"] ** 2 / base["n"]
+    vc = cand["stdev"] ** 2 / cand["n"]
+    if not math.isfinite(vb + vc):
+        return None
+    diff = cand["mean"] - base["mean"]
+    if vb + vc == 0.0:
+        # Constant samples: any difference is certain
+        if diff == 0.0:
+            return 0.0, math.inf, 1.0
+        return math.copysign(math.inf, diff), math.inf, 0.0
+    t = diff / math.sqrt(vb + vc)
+    df = (vb + vc) ** 2 / (vb**2 / (base["n"] - 1) + vc**2 / (cand["n"] - 1))
+    p = betainc(df / 2.0, 0.5, df / (df + t * t))
+    return t, df, p
+
+
+def higher_is_better(unit):
+    return unit.endswith("/s")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Flag significant regressions between two bench result files."
+    )
+    parser.add_argument("baseline", help="reference result file (JSON or CSV)")
+    parser.add_argument("candidate", help="result file to check (JSON or CSV)")
+    parser.add_argument(
+        "--alpha", type=float, default=0.05, help="significance level (default 0.05)"
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.02,
+        help="minimal relative degradation to report (default 0.02)",
+    )
+    args = parser.parse_args()
+
+    base, base_meta = load_results(args.baseline)
+    cand, cand_meta = load_results(args.candidate)
+
+    for key in ("tool", "host", "cpu", "compiler", "build_profile"):
+        if base_meta.get(key) != cand_meta.get(key):
+            print(
+                "warning: {} differs: {!r} vs {!r}".format(
+                    key, base_meta.get(key), cand_meta.get(key)
+                )
+            )
+
+    regressions = 0
+    rows = []
+    for key in base:
+        if key not in cand:
+            continue
+        b = base[key]
+        c = cand[key]
+        change = (c["mean"] - b["mean"]) / b["mean"] if b["mean"] else math.nan
+        worse = -change if higher_is_better(b["unit"]) else change
+        test = welch_test(b, c)
+        p = test[2] if test else math.nan
+        significant = test is not None and p < args.alpha
+        if significant and worse > args.threshold:
+            status = "REGRESSION"
+            regressions += 1
+        elif significant and worse < -args.threshold:
+            status = "improvement"
+        else:
+            status = ""
+        rows.append((key[0], key[1], b["unit"], b["mean"], c["mean"], change, p, status))
+
+    missing = [k for k in base if k not in cand] + [k for k in cand if k not in base]
+    for benchmark, metric in missing:
+        print("warning: {} / {} is only in one file".format(benchmark, metric))
+
+    width = max([len(r[0]) for r in rows] + [len("benchmark")])
+    print(
+        "{:<{w}}  {:<16} {:>14} {:>14} {:>9} {:>8}  {}".format(
+            "benchmark", "metric", "baseline", "candidate", "change", "p", "", w=width
+        )
+    )
+    for benchmark, metric, unit, mb, mc, change, p, status in rows:
+        print(
+            "{:<{w}}  {:<16} {:>14.6g} {:>14.6g} {:>+8.2f}% {:>8.3g}  {}".format(
+                benchmark, metric, mb, mc, 100 * change, p, status, w=width
+            )
+        )
+
+    print(
+        "{} regression(s) at alpha={} with threshold {:.1f}%".format(
+            regressions, args.alpha, 100 * args.threshold
+        )
+    )
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,8 +2,12 @@
  * SPDX-License-Identifier: GPL-2.0-only
  */
 
+#include "../bench-results.h"
+
 #include "ns3/core-module.h"
 
+#include "simulation-domestique-async-writer.h"
+
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
@@ -53,6 +57,28 @@ PerfStream(std::ostream& stream, uint32_t n, const char* buffer, uint32_t size)
     }
 }
 
+/**
+ * @ingroup system-tests-perf
+ *
+ * Check the performance of writing to file through the asynchronous
+ * ring-buffer writer.  The caller only copies each buffer into the ring;
+ * the fwrite calls happen on the writer's background thread.
+ *
+ * @param writer The asynchronous writer.
+ * @param file The writer file index to write to.
+ * @param n The number of writes to perform.
+ * @param buffer The buffer to write.
+ * @param size The buffer size.
+ */
+void
+PerfAsync(AsyncTraceWriter& writer, int32_t file, uint32_t n, const char* buffer, uint32_t size)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        writer.Write(file, buffer, size);
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -60,6 +86,9 @@ main(int argc, char* argv[])
     uint32_t iter = 50;
     bool doStream = false;
     bool binmode = true;
+    bool doAsync = false;
+    uint32_t ringKb = 16384;
+    std::string resultsFile = "";
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("n", "How many times to write (defaults to 100000", n);
@@ -68,20 +97,76 @@ main(int argc, char* argv[])
     cmd.AddValue("binmode",
                  "Select binary mode for the C++ I/O benchmark (defaults to true)",
                  binmode);
+    cmd.AddValue("doAsync",
+                 "Run the asynchronous ring-buffer writer benchmark (overrides doStream)",
+                 doAsync);
+    cmd.AddValue("ringKb", "Ring buffer size in KiB for doAsync (defaults to 16384)", ringKb);
+    cmd.AddValue("results",
+                 "Write every iteration to this file, as CSV (.csv) or JSON",
+                 resultsFile);
     cmd.Parse(argc, argv);
 
+    BenchResults results("perf-io", argc, argv);
+
     auto minResultNs =
         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::nanoseconds::max());
+    auto minClosedNs = minResultNs;
 
     char buffer[1024];
 
-    if (doStream)
+    //
+    // Every mode times the same operations, once the file is open: the
+    // writes alone ("write"), then the writes followed by the close that
+    // hands all the data to the system ("closed").  For the asynchronous
+    // writer, "write" is the time seen by the writing thread (copies into
+    // the ring, plus any wait when the ring is full) and the close waits
+    // for the background thread to drain the ring.
+    //
+    // This will probably run on a machine doing other things.  Run it some
+    // relatively large number of times and try to find a minimum, which
+    // will hopefully represent a time when it runs free of interference.
+    //
+    std::string benchmark;
+    auto record = [&](std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point written,
+                      std::chrono::steady_clock::time_point closed) {
+        auto resultNs = std::chrono::duration_cast<std::chrono::nanoseconds>(written - start);
+        auto closedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(closed - start);
+        minResultNs = std::min(resultNs, minResultNs);
+        minClosedNs = std::min(closedNs, minClosedNs);
+        results.Add(benchmark, "write", "ns", resultNs.count());
+        results.Add(benchmark, "closed", "ns", closedNs.count());
+        std::cout << ".";
+        std::cout.flush();
+    };
+
+    if (doAsync)
     {
-        //
-        // This will probably run on a machine doing other things.  Run it some
-        // relatively large number of times and try to find a minimum, which
-        // will hopefully represent a time when it runs free of interference.
-        //
+        benchmark = "async";
+        AsyncWriterStats stats;
+        for (uint32_t i = 0; i < iter; ++i)
+        {
+            AsyncTraceWriter writer(std::size_t(ringKb) * 1024);
+            int32_t file = writer.Open("asynctest");
+            NS_ABORT_MSG_IF(file < 0, "PerfAsync():  cannot open asynctest");
+
+            auto start = std::chrono::steady_clock::now();
+            PerfAsync(writer, file, n, buffer, 1024);
+            auto written = std::chrono::steady_clock::now();
+            writer.Close();
+            auto closed = std::chrono::steady_clock::now();
+            record(start, written, closed);
+            stats = writer.GetStats();
+        }
+        std::cout << std::endl;
+        std::cout << argv[0] << ": last run: " << stats.stalls << " of " << stats.records
+                  << " writes stalled on a full ring (" << stats.stallSeconds * 1000.0
+                  << "ms), max fill " << stats.maxFill << " of " << std::size_t(ringKb) * 1024
+                  << " bytes, " << stats.batches << " batches" << std::endl;
+    }
+    else if (doStream)
+    {
+        benchmark = binmode ? "stream-binary" : "stream-text";
         for (uint32_t i = 0; i < iter; ++i)
         {
             std::ofstream stream;
@@ -96,41 +181,40 @@ main(int argc, char* argv[])
 
             auto start = std::chrono::steady_clock::now();
             PerfStream(stream, n, buffer, 1024);
-            auto end = std::chrono::steady_clock::now();
-            auto resultNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-            resultNs = std::min(resultNs, minResultNs);
+            auto written = std::chrono::steady_clock::now();
             stream.close();
-            std::cout << ".";
-            std::cout.flush();
+            auto closed = std::chrono::steady_clock::now();
+            record(start, written, closed);
         }
 
         std::cout << std::endl;
     }
     else
     {
-        //
-        // This will probably run on a machine doing other things.  Run it some
-        // relatively large number of times and try to find a minimum, which
-        // will hopefully represent a time when it runs free of interference.
-        //
+        benchmark = "file";
         for (uint32_t i = 0; i < iter; ++i)
         {
             FILE* file = fopen("filetest", "w");
 
             auto start = std::chrono::steady_clock::now();
             PerfFile(file, n, buffer, 1024);
-            auto end = std::chrono::steady_clock::now();
-            auto resultNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-            resultNs = std::min(resultNs, minResultNs);
+            auto written = std::chrono::steady_clock::now();
             fclose(file);
+            auto closed = std::chrono::steady_clock::now();
             file = nullptr;
-            std::cout << ".";
-            std::cout.flush();
+            record(start, written, closed);
         }
         std::cout << std::endl;
     }
 
-    std::cout << argv[0] << ": " << minResultNs.count() << "ns" << std::endl;
+    std::cout << argv[0] << ": " << minResultNs.count() << "ns; written and closed in "
+              << minClosedNs.count() << "ns" << std::endl;
+
+    if (!resultsFile.empty())
+    {
+        NS_ABORT_MSG_UNLESS(results.Write(resultsFile), "Cannot write " << resultsFile);
+        std::cout << argv[0] << ": results written to " << resultsFile << std::endl;
+    }
 
     return 0;
 }